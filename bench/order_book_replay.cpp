@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "order_book.h"
+
+// Replay of a synthetic ITCH-like message stream through the order book.
+// Prices of new orders are drawn around the current mid with geometrically
+// decaying distance, so most of the activity happens near the top of book
+
+enum class message_type : uint32_t {
+  kAdd,
+  kExecute,
+  kCancel,
+  kDelete,
+  kReplace
+};
+
+struct message {
+  message_type type;
+  uint64_t id;
+  uint64_t new_id;
+  splay::order_side side;
+  int64_t price;
+  uint64_t quantity;
+};
+
+std::vector<message> generate_messages(size_t count, uint32_t seed) {
+  auto generator = std::mt19937_64{seed};
+  auto distance = std::geometric_distribution<int64_t>{0.3};
+  auto quantity = std::uniform_int_distribution<uint64_t>{1, 500};
+  auto action = std::uniform_int_distribution<uint32_t>{0, 99};
+  auto coin = std::bernoulli_distribution{0.5};
+  const auto mid = int64_t{100000};
+  auto live = std::vector<std::pair<uint64_t, splay::order_side>>{};
+  auto messages = std::vector<message>{};
+  messages.reserve(count);
+  auto next_id = uint64_t{1};
+  while (messages.size() < count) {
+    const auto roll = action(generator);
+    if (live.empty() || roll < 45) {
+      const auto side = coin(generator) ? splay::order_side::kBuy : splay::order_side::kSell;
+      const auto offset = 1 + distance(generator);
+      const auto price = side == splay::order_side::kBuy ? mid - offset : mid + offset;
+      messages.push_back(message{message_type::kAdd, next_id, 0, side, price, quantity(generator)});
+      live.emplace_back(next_id, side);
+      ++next_id;
+      continue;
+    }
+    const auto idx = static_cast<size_t>(generator() % live.size());
+    const auto target = live[idx];
+    if (roll < 60) {
+      messages.push_back(message{message_type::kExecute, target.first, 0, target.second, 0, quantity(generator)});
+    } else if (roll < 70) {
+      messages.push_back(message{message_type::kCancel, target.first, 0, target.second, 0, quantity(generator)});
+    } else if (roll < 90) {
+      messages.push_back(message{message_type::kDelete, target.first, 0, target.second, 0, 0});
+      live[idx] = live.back();
+      live.pop_back();
+    } else {
+      const auto offset = 1 + distance(generator);
+      const auto price = target.second == splay::order_side::kBuy ? mid - offset : mid + offset;
+      messages.push_back(message{
+        message_type::kReplace, target.first, next_id, target.second, price, quantity(generator)});
+      live[idx].first = next_id;
+      ++next_id;
+    }
+  }
+  return messages;
+}
+
+void replay(splay::order_book& book, const std::vector<message>& messages) {
+  for (const auto& item : messages) {
+    switch (item.type) {
+      case message_type::kAdd:
+        book.add(item.id, item.side, item.price, item.quantity);
+        break;
+      case message_type::kExecute:
+        book.execute(item.id, item.quantity);
+        break;
+      case message_type::kCancel:
+        book.reduce(item.id, item.quantity);
+        break;
+      case message_type::kDelete:
+        book.cancel(item.id);
+        break;
+      case message_type::kReplace:
+        book.replace(item.id, item.new_id, item.price, item.quantity);
+        break;
+    }
+  }
+}
+
+int main() {
+  const auto count = size_t{5000000};
+  const auto messages = generate_messages(count, 2024);
+  auto book = splay::order_book{};
+  const auto start = std::chrono::steady_clock::now();
+  replay(book, messages);
+  const auto finish = std::chrono::steady_clock::now();
+  const auto seconds = std::chrono::duration<double>(finish - start).count();
+  std::cout << "messages:       " << count << '\n'
+            << "seconds:        " << seconds << '\n'
+            << "messages/s:     " << static_cast<double>(count) / seconds << '\n'
+            << "resting orders: " << book.size() << '\n'
+            << "bid levels:     " << book.depth(splay::order_side::kBuy) << '\n'
+            << "ask levels:     " << book.depth(splay::order_side::kSell) << '\n'
+            << "traded volume:  " << book.traded_volume() << '\n';
+  return 0;
+}
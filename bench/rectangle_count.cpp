@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "rectangle_counter.h"
+
+// Offline rectangle counting: the nested loop over points and rectangles
+// against the sweep and its parallel slab variant on random input
+
+using point = splay::plane_point<int64_t>;
+using rectangle = splay::plane_rectangle<int64_t>;
+
+std::vector<size_t> count_nested(const std::vector<point>& points, const std::vector<rectangle>& rectangles) {
+  auto counts = std::vector<size_t>(rectangles.size(), size_t{0});
+  for (auto idx = size_t{0}; idx < rectangles.size(); ++idx) {
+    const auto& area = rectangles[idx];
+    for (const auto& item : points) {
+      if (area.x_low <= item.x && item.x <= area.x_high && area.y_low <= item.y && item.y <= area.y_high) {
+        ++counts[idx];
+      }
+    }
+  }
+  return counts;
+}
+
+template <typename Counter>
+double measure(const char* name, Counter counter, const std::vector<size_t>& expected) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto counts = counter();
+  const auto finish = std::chrono::steady_clock::now();
+  const auto seconds = std::chrono::duration<double>(finish - start).count();
+  std::cout << name << seconds << " s" << (counts == expected ? "" : " (MISMATCH)") << '\n';
+  return seconds;
+}
+
+int main() {
+  const auto point_count = size_t{1000000};
+  const auto rectangle_count = size_t{1000000};
+  const auto nested_count = size_t{1000};
+  auto generator = std::mt19937_64{2024};
+  auto coordinate = std::uniform_int_distribution<int64_t>{0, 1000000000};
+  auto points = std::vector<point>{};
+  for (auto idx = size_t{0}; idx < point_count; ++idx) {
+    points.push_back(point{coordinate(generator), coordinate(generator)});
+  }
+  auto rectangles = std::vector<rectangle>{};
+  for (auto idx = size_t{0}; idx < rectangle_count; ++idx) {
+    const auto x1 = coordinate(generator);
+    const auto x2 = coordinate(generator);
+    const auto y1 = coordinate(generator);
+    const auto y2 = coordinate(generator);
+    rectangles.push_back(rectangle{std::min(x1, x2), std::max(x1, x2), std::min(y1, y2), std::max(y1, y2)});
+  }
+  const auto expected = splay::count_rectangles(points, rectangles);
+  std::cout << "points:         " << point_count << '\n'
+            << "rectangles:     " << rectangle_count << '\n';
+  const auto sample = std::vector<rectangle>(
+    std::begin(rectangles), std::begin(rectangles) + nested_count);
+  const auto nested = measure("nested loop:    ", [&]() {
+    return count_nested(points, sample);
+  }, std::vector<size_t>(std::begin(expected), std::begin(expected) + nested_count));
+  std::cout << "  extrapolated: " << nested * rectangle_count / nested_count << " s\n";
+  measure("sweep:          ", [&]() {
+    return splay::count_rectangles(points, rectangles);
+  }, expected);
+  measure("parallel sweep: ", [&]() {
+    return splay::count_rectangles_parallel(points, rectangles);
+  }, expected);
+  return 0;
+}
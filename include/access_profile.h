@@ -0,0 +1,139 @@
+#ifndef SPLAY_TREE_ACCESS_PROFILE_H_
+#define SPLAY_TREE_ACCESS_PROFILE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+// Sampled access counts per key. Every access is recorded with probability
+// 1 / `sample_period`, so hot keys are counted at a fraction of the cost of
+// exact counting. The counts can be saved with `entries` and loaded with
+// `load`, for example together with a snapshot of the tree, and turned into
+// a weighted tree shape with `rebuild_from_profile`
+template <typename Key, typename KeyComparator = std::less<Key>>
+class access_profile {
+ public:
+  using entry_type = std::pair<Key, uint64_t>;
+
+  explicit access_profile(
+      uint32_t sample_period = 1,
+      const KeyComparator& comparator = KeyComparator{},
+      uint32_t seed = 5489u)
+    : counts{comparator}
+    , generator{seed}
+    , sample_period{sample_period}
+    , samples{0}
+  {
+    assert(sample_period != 0);
+  }
+
+  // number of distinct sampled keys
+  size_t size() const noexcept {
+    return counts.size();
+  }
+
+  bool empty() const noexcept {
+    return counts.empty();
+  }
+
+  uint64_t total_samples() const noexcept {
+    return samples;
+  }
+
+  void clear() noexcept {
+    counts.clear();
+    samples = 0;
+  }
+
+  // note an access to `key`
+  void record(const Key& key) {
+    if (sample_period != 1 && generator() % sample_period != 0) {
+      return;
+    }
+    ++counts[key];
+    ++samples;
+  }
+
+  // sampled count of `key`
+  uint64_t count(const Key& key) const {
+    auto it = counts.find(key);
+    return it != counts.end() ? it->second : uint64_t{0};
+  }
+
+  // sampled counts in key order
+  std::vector<entry_type> entries() const {
+    return std::vector<entry_type>(std::begin(counts), std::end(counts));
+  }
+
+  // add saved counts `entries` to the profile
+  void load(const std::vector<entry_type>& entries) {
+    for (const auto& entry : entries) {
+      counts[entry.first] += entry.second;
+      samples += entry.second;
+    }
+  }
+
+  // halve all counts to let the profile follow a drifting workload
+  void decay() {
+    samples = 0;
+    for (auto it = counts.begin(); it != counts.end();) {
+      it->second /= 2;
+      samples += it->second;
+      it = it->second != 0 ? std::next(it) : counts.erase(it);
+    }
+  }
+
+  // weights of the nodes of `tree` in key order: the sampled count plus one,
+  // so keys never sampled still get a place. Walks the tree and the profile
+  // side by side in O(n + p)
+  template <typename Value, typename KeyExtractor>
+  std::vector<uint64_t> weights(const splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree) const {
+    auto result = std::vector<uint64_t>{};
+    result.reserve(tree.size());
+    if (tree.empty()) {
+      return result;
+    }
+    const auto comparator = tree.key_comparator();
+    const auto extractor = tree.key_extractor();
+    auto it = counts.begin();
+    for (auto node = tree.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      const auto& key = extractor(node->value);
+      while (it != counts.end() && comparator(it->first, key)) {
+        ++it;
+      }
+      const auto sampled = it != counts.end() && !comparator(key, it->first);
+      result.push_back(uint64_t{1} + (sampled ? it->second : uint64_t{0}));
+    }
+    return result;
+  }
+
+ private:
+  std::map<Key, uint64_t, KeyComparator> counts;
+  std::minstd_rand generator;
+  uint32_t sample_period;
+  uint64_t samples;
+};
+
+// reshape `tree` so frequently accessed keys of `profile` sit near the root.
+// Node depths follow Mehlhorn's bisection rule, a key with weight `w` out of
+// total weight `W` ends up at depth O(log (W / w)), within a constant factor
+// of the optimal static tree. Takes O(n log n), no nodes are reallocated
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+void rebuild_from_profile(
+    splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree,
+    const access_profile<Key, KeyComparator>& profile) {
+  tree.rebuild_weighted(profile.weights(tree));
+}
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_ACCESS_PROFILE_H_
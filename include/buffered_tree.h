@@ -0,0 +1,211 @@
+#ifndef SPLAY_TREE_BUFFERED_TREE_H_
+#define SPLAY_TREE_BUFFERED_TREE_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+// Splay tree shared by many writer threads. Every thread writes through its
+// own `write_buffer`, which collects inserts and erases without locking and
+// applies them once full (or on `flush`) in a single locked pass sorted by key.
+// One lock acquisition is paid per batch instead of per write, and the batch
+// touches keys in ascending order, so every splay starts near the previous
+// one. By the dynamic finger bound a batch of `b` writes spread over the tree
+// costs O(b log (n / b)) amortized rotations instead of O(b log n), and only
+// O(b + log n) when the keys are adjacent in the tree
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+class buffered_tree {
+ public:
+  using tree_type = splay_tree<Key, Value, KeyComparator, KeyExtractor>;
+
+ private:
+  struct operation {
+    Key key;
+    Value value;
+    bool erase;
+  };
+
+ public:
+  // Pending writes of one thread. Writes of a buffer become visible to other
+  // threads in the order they were made, writes of different buffers to the
+  // same key are ordered by the flushes. The buffer is flushed on destruction
+  // and must not be used by several threads at once
+  class write_buffer {
+   public:
+    write_buffer(buffered_tree& owner, size_t capacity)
+      : owner{&owner}
+      , pending{}
+      , capacity{capacity}
+    {
+      assert(capacity != 0);
+      pending.reserve(capacity);
+    }
+
+    write_buffer(const write_buffer& other) = delete;
+    write_buffer& operator = (const write_buffer& other) = delete;
+
+    write_buffer(write_buffer&& other) noexcept
+      : owner{other.owner}
+      , pending{std::move(other.pending)}
+      , capacity{other.capacity}
+    {
+      other.owner = nullptr;
+    }
+
+    ~write_buffer() {
+      if (owner != nullptr) {
+        this->flush();
+      }
+    }
+
+    // insert `value` or replace the value with the same key
+    void insert(const Value& value) {
+      const auto& key = owner->extractor(value);
+      this->push(operation{key, value, false});
+    }
+
+    // remove the value with key `key` if present
+    void erase(const Key& key) {
+      this->push(operation{key, Value{}, true});
+    }
+
+    // number of writes waiting for a flush
+    size_t size() const noexcept {
+      return pending.size();
+    }
+
+    bool empty() const noexcept {
+      return pending.empty();
+    }
+
+    // apply all pending writes to the shared tree
+    void flush() {
+      if (!pending.empty()) {
+        owner->apply(pending);
+        pending.clear();
+      }
+    }
+
+   private:
+    void push(operation&& write) {
+      pending.push_back(std::move(write));
+      if (pending.size() >= capacity) {
+        this->flush();
+      }
+    }
+
+    buffered_tree* owner;
+    std::vector<operation> pending;
+    size_t capacity;
+  };
+
+  explicit buffered_tree(
+      size_t buffer_capacity = 256,
+      const KeyComparator& comparator = KeyComparator{},
+      const KeyExtractor& extractor = KeyExtractor{})
+    : tree{comparator, extractor}
+    , comparator{comparator}
+    , extractor{extractor}
+    , buffer_capacity{buffer_capacity}
+    , batches{0}
+    , mutex{}
+  {}
+
+  // write buffers point to the tree, so it can't be copied or moved
+  buffered_tree(const buffered_tree& other) = delete;
+  buffered_tree& operator = (const buffered_tree& other) = delete;
+
+  // a new buffer for the calling thread, usually one per thread for its lifetime
+  write_buffer make_buffer() {
+    return write_buffer{*this, buffer_capacity};
+  }
+
+  write_buffer make_buffer(size_t capacity) {
+    return write_buffer{*this, capacity};
+  }
+
+  // copy the value with key `key` into `value`, returns false if the key is
+  // missing. Writes still pending in buffers are not seen
+  bool find(const Key& key, Value& value) {
+    std::lock_guard<std::mutex> lock{mutex};
+    auto node = tree.find(key);
+    if (node == nullptr) {
+      return false;
+    }
+    value = node->value;
+    return true;
+  }
+
+  // read your writes: flush `buffer` before the lookup
+  bool find(const Key& key, Value& value, write_buffer& buffer) {
+    buffer.flush();
+    return this->find(key, value);
+  }
+
+  bool contains(const Key& key) {
+    std::lock_guard<std::mutex> lock{mutex};
+    return tree.find(key) != nullptr;
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock{mutex};
+    return tree.size();
+  }
+
+  // number of flushed batches
+  uint64_t batch_count() {
+    std::lock_guard<std::mutex> lock{mutex};
+    return batches;
+  }
+
+  // call `function(tree)` with the shared tree locked
+  template <typename Function>
+  auto with_tree(Function function) -> decltype(function(std::declval<tree_type&>())) {
+    std::lock_guard<std::mutex> lock{mutex};
+    return function(tree);
+  }
+
+ private:
+  // sort the writes by key keeping the order of writes to the same key, only
+  // the last write of every key is applied
+  void apply(std::vector<operation>& writes) {
+    std::stable_sort(std::begin(writes), std::end(writes), [this](const operation& lhs, const operation& rhs) {
+      return comparator(lhs.key, rhs.key);
+    });
+    std::lock_guard<std::mutex> lock{mutex};
+    for (auto it = std::begin(writes); it != std::end(writes); ++it) {
+      const auto next = std::next(it);
+      if (next != std::end(writes) && !comparator(it->key, next->key)) {
+        continue;
+      }
+      if (it->erase) {
+        auto node = tree.find(it->key);
+        if (node != nullptr) {
+          tree.erase(node);
+        }
+      } else if (tree.insert(it->value) == nullptr) {
+        tree.find(it->key)->value = it->value;
+      }
+    }
+    ++batches;
+  }
+
+  tree_type tree;
+  KeyComparator comparator;
+  KeyExtractor extractor;
+  size_t buffer_capacity;
+  uint64_t batches;
+  std::mutex mutex;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_BUFFERED_TREE_H_
@@ -0,0 +1,222 @@
+#ifndef SPLAY_TREE_FAST_RANGE_COUNTER_H_
+#define SPLAY_TREE_FAST_RANGE_COUNTER_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+namespace detail {
+
+// number of elements of `tree` with keys in [low, high]: the range is split
+// out into its own tree, whose size is read off the root, and merged back
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+size_t count_between(
+    splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree,
+    const Key& low,
+    const Key& high) {
+  auto low_node = tree.lower_bound(low);
+  auto middle_right_tree = tree.split_right(low_node);
+  auto& left_tree = tree;
+  auto high_node = middle_right_tree.upper_bound(high);
+  auto right_tree = middle_right_tree.split_right(high_node);
+  auto& middle_tree = middle_right_tree;
+  const auto total = (!middle_tree.empty() ? middle_tree.size() : size_t{0});
+  middle_tree.merge(right_tree);
+  left_tree.merge(middle_tree);
+  return total;
+}
+
+}  // namespace detail
+
+template <typename T>
+class fast_range_counter {
+ private:
+
+  template <typename Key>
+  struct default_key_extractor {
+    const Key& operator () (const Key& t) const {
+      return t;
+    }
+  };
+
+  template <typename Key>
+  struct default_key_comparator {
+    bool operator ()(const Key& lhs, const Key& rhs) const {
+      return lhs < rhs;
+    }
+  };
+
+ public:
+  using tree_type = splay_tree<T, T, default_key_comparator<T>, default_key_extractor<T>>;
+
+  fast_range_counter()
+    : tree{}
+  {}
+
+  void add(const T& number) {
+    tree.insert(number);
+  }
+
+  void remove(const T& number) {
+    auto node = tree.find(number);
+    if (node != nullptr) {
+      tree.erase(node);
+    }
+  }
+
+  bool contains(const T& number) {
+    auto node = tree.find(number);
+    return (node != nullptr);
+  }
+
+  size_t count(const T& low, const T& high) {
+    assert(low <= high);
+    return detail::count_between(tree, low, high);
+  }
+
+  const tree_type& get_tree() const {
+    return tree;
+  }
+
+ private:
+  tree_type tree;
+};
+
+// Range counter whose elements expire `ttl` after they were added. Besides the
+// tree of elements, insertion times are kept in a second splay tree ordered by
+// (timestamp, arrival). Expiry splits the time tree once at the first live
+// timestamp and erases the detached prefix, so every expired element costs
+// O(log n) amortized and no per element timers are needed
+template <typename T>
+class expiring_range_counter {
+ private:
+  struct element;
+
+  struct stamp {
+    int64_t timestamp;
+    uint64_t sequence;
+    tree_node<element>* element_node;
+  };
+
+  struct element {
+    T number;
+    tree_node<stamp>* stamp_node;
+
+    friend std::ostream& operator << (std::ostream& out, const element& value) {
+      out << value.number;
+      return out;
+    }
+  };
+
+  struct element_key_extractor {
+    const T& operator () (const element& value) const {
+      return value.number;
+    }
+  };
+
+  struct element_key_comparator {
+    bool operator ()(const T& lhs, const T& rhs) const {
+      return lhs < rhs;
+    }
+  };
+
+  struct stamp_key_extractor {
+    std::pair<int64_t, uint64_t> operator () (const stamp& value) const {
+      return std::make_pair(value.timestamp, value.sequence);
+    }
+  };
+
+  using stamp_key_comparator = std::less<std::pair<int64_t, uint64_t>>;
+
+ public:
+  using tree_type = splay_tree<T, element, element_key_comparator, element_key_extractor>;
+  using stamp_tree_type = splay_tree<
+    std::pair<int64_t, uint64_t>, stamp, stamp_key_comparator, stamp_key_extractor>;
+
+  explicit expiring_range_counter(int64_t ttl)
+    : tree{}
+    , stamps{}
+    , ttl{ttl}
+    , next_sequence{0}
+  {}
+
+  // elements and stamps point to each other, so the counter can't be copied
+  expiring_range_counter(const expiring_range_counter& other) = delete;
+  expiring_range_counter(expiring_range_counter&& other) = default;
+  expiring_range_counter& operator = (const expiring_range_counter& other) = delete;
+  expiring_range_counter& operator = (expiring_range_counter&& other) = default;
+
+  // add `number` at time `timestamp`, adding a present number refreshes it
+  // timestamps must not decrease
+  void add(const T& number, int64_t timestamp) {
+    auto node = tree.find(number);
+    if (node != nullptr) {
+      stamps.erase(node->value.stamp_node);
+    } else {
+      node = tree.insert(element{number, nullptr});
+    }
+    auto stamp_node = stamps.insert(stamp{timestamp, next_sequence++, node});
+    assert(stamp_node != nullptr);
+    node->value.stamp_node = stamp_node;
+  }
+
+  void remove(const T& number) {
+    auto node = tree.find(number);
+    if (node != nullptr) {
+      stamps.erase(node->value.stamp_node);
+      tree.erase(node);
+    }
+  }
+
+  // drop all elements added at or before `now - ttl`
+  void expire(int64_t now) {
+    const auto cutoff = std::make_pair(now - ttl, std::numeric_limits<uint64_t>::max());
+    auto live = stamps.split_right(stamps.upper_bound(cutoff));
+    auto& expired = stamps;
+    if (!expired.empty()) {
+      for (auto it = expired.root()->leftmost_node(); it != nullptr; it = it->next_node()) {
+        tree.erase(it->value.element_node);
+      }
+      expired.clear();
+    }
+    stamps.swap(live);
+  }
+
+  bool contains(const T& number, int64_t now) {
+    this->expire(now);
+    auto node = tree.find(number);
+    return (node != nullptr);
+  }
+
+  // number of live elements at time `now` in [low, high]
+  size_t count(const T& low, const T& high, int64_t now) {
+    assert(low <= high);
+    this->expire(now);
+    return detail::count_between(tree, low, high);
+  }
+
+  size_t size() const noexcept {
+    return tree.size();
+  }
+
+  const tree_type& get_tree() const {
+    return tree;
+  }
+
+ private:
+  tree_type tree;
+  stamp_tree_type stamps;
+  int64_t ttl;
+  uint64_t next_sequence;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_FAST_RANGE_COUNTER_H_
@@ -0,0 +1,172 @@
+#ifndef SPLAY_TREE_FREE_SPACE_INDEX_H_
+#define SPLAY_TREE_FREE_SPACE_INDEX_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+// free range [offset, offset + length)
+struct free_extent {
+  uint64_t offset;
+  uint64_t length;
+};
+
+inline std::ostream& operator << (std::ostream& out, const free_extent& extent) {
+  out << "[" << extent.offset << ", " << extent.offset + extent.length << ")";
+  return out;
+}
+
+namespace detail {
+
+struct extent_offset_extractor {
+  uint64_t operator () (const free_extent& extent) const noexcept {
+    return extent.offset;
+  }
+};
+
+struct extent_length_extractor {
+  std::pair<uint64_t, uint64_t> operator () (const free_extent& extent) const noexcept {
+    return std::make_pair(extent.length, extent.offset);
+  }
+};
+
+}  // namespace detail
+
+// Free space of a linear address range. Free extents are kept twice: ordered
+// by offset to find and coalesce neighbours of a released extent, and ordered
+// by (length, offset) to find the smallest extent that fits an allocation
+// (best fit, lowest offset among equal lengths). Allocation and release cost
+// O(log n) amortized in the number of free extents
+class free_space_index {
+ public:
+  using offset_tree_type = splay_tree<
+    uint64_t, free_extent, std::less<uint64_t>, detail::extent_offset_extractor>;
+  using length_tree_type = splay_tree<
+    std::pair<uint64_t, uint64_t>, free_extent, std::less<std::pair<uint64_t, uint64_t>>,
+    detail::extent_length_extractor>;
+
+  // returned by `allocate` when no extent is large enough
+  static constexpr uint64_t kNoSpace = std::numeric_limits<uint64_t>::max();
+
+  free_space_index()
+    : by_offset{}
+    , by_length{}
+    , free_total{0}
+  {}
+
+  // index with the whole range [offset, offset + length) free
+  free_space_index(uint64_t offset, uint64_t length)
+    : free_space_index{} {
+    this->release(offset, length);
+  }
+
+  size_t extent_count() const noexcept {
+    return by_offset.size();
+  }
+
+  uint64_t free_bytes() const noexcept {
+    return free_total;
+  }
+
+  // length of the largest free extent
+  uint64_t largest_extent() {
+    if (by_length.empty()) {
+      return 0;
+    }
+    auto node = by_length.order_statistic(by_length.size() - 1);
+    return node->value.length;
+  }
+
+  // reserve `length` units from the best fitting extent, returns the offset
+  // of the reserved range or `kNoSpace`
+  uint64_t allocate(uint64_t length) {
+    assert(length != 0);
+    auto node = by_length.lower_bound(std::make_pair(length, uint64_t{0}));
+    if (node == nullptr) {
+      return kNoSpace;
+    }
+    const auto extent = node->value;
+    this->remove(extent);
+    if (extent.length > length) {
+      this->add(free_extent{extent.offset + length, extent.length - length});
+    }
+    return extent.offset;
+  }
+
+  // return range [offset, offset + length) to the free space merging it with
+  // adjacent free extents, the range must not overlap free space
+  void release(uint64_t offset, uint64_t length) {
+    if (length == 0) {
+      return;
+    }
+    auto extent = free_extent{offset, length};
+    auto next = by_offset.lower_bound(offset);
+    auto prev = next != nullptr ? next->prev_node() : (
+      !by_offset.empty() ? by_offset.root()->rightmost_node() : nullptr);
+    assert(next == nullptr || offset + length <= next->value.offset);
+    assert(prev == nullptr || prev->value.offset + prev->value.length <= offset);
+    if (next != nullptr && offset + length == next->value.offset) {
+      const auto neighbour = next->value;
+      extent.length += neighbour.length;
+      this->remove(neighbour);
+    }
+    if (prev != nullptr && prev->value.offset + prev->value.length == offset) {
+      const auto neighbour = prev->value;
+      extent.offset = neighbour.offset;
+      extent.length += neighbour.length;
+      this->remove(neighbour);
+    }
+    this->add(extent);
+  }
+
+  // call `visitor` for every free extent in offset order
+  template <typename Visitor>
+  void for_each(Visitor visitor) const {
+    if (by_offset.empty()) {
+      return;
+    }
+    for (auto node = by_offset.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      visitor(node->value);
+    }
+  }
+
+  const offset_tree_type& get_offset_tree() const noexcept {
+    return by_offset;
+  }
+
+  const length_tree_type& get_length_tree() const noexcept {
+    return by_length;
+  }
+
+ private:
+  void add(const free_extent& extent) {
+    by_offset.insert(extent);
+    by_length.insert(extent);
+    free_total += extent.length;
+  }
+
+  void remove(const free_extent& extent) {
+    auto offset_node = by_offset.find(extent.offset);
+    assert(offset_node != nullptr);
+    by_offset.erase(offset_node);
+    auto length_node = by_length.find(std::make_pair(extent.length, extent.offset));
+    assert(length_node != nullptr);
+    by_length.erase(length_node);
+    free_total -= extent.length;
+  }
+
+  offset_tree_type by_offset;
+  length_tree_type by_length;
+  uint64_t free_total;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_FREE_SPACE_INDEX_H_
@@ -1,13 +1,191 @@
 #ifndef SPLAY_TREE_IMPLICIT_SPLAY_TREE_H_
 #define SPLAY_TREE_IMPLICIT_SPLAY_TREE_H_
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <vector>
 
 #include "tree_impl.h"
 
 namespace splay {
 
+namespace detail {
+
+// Random access iterator over an implicit splay tree. Steps of a few positions
+// follow the in-order links from the current node, longer jumps descend from
+// the root by subtree sizes. A mutable iterator splays the target of a long
+// jump like `operator []`, so jumps cost O(log n) amortized. A const iterator
+// doesn't reshape the tree and a long jump costs O(depth). Splaying keeps
+// nodes and positions, so iterators stay valid until nodes are inserted or
+// erased
+template <typename Value, bool IsConst>
+class implicit_tree_iterator {
+  using node_pointer = typename std::conditional<IsConst, const tree_node<Value>*, tree_node<Value>*>::type;
+  using tree_pointer = typename std::conditional<
+    IsConst, const splay_tree_base<Value>*, splay_tree_base<Value>*>::type;
+
+  // jumps up to this distance walk the in-order links
+  static constexpr std::ptrdiff_t kMaxWalk = 16;
+
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = Value;
+  using difference_type = std::ptrdiff_t;
+  using pointer = typename std::conditional<IsConst, const Value*, Value*>::type;
+  using reference = typename std::conditional<IsConst, const Value&, Value&>::type;
+
+  implicit_tree_iterator() noexcept
+    : tree{nullptr}
+    , node{nullptr}
+    , position{0}
+  {}
+
+  implicit_tree_iterator(tree_pointer tree, node_pointer node, size_t position) noexcept
+    : tree{tree}
+    , node{node}
+    , position{position}
+  {}
+
+  // iterator converts to const iterator
+  template <bool OtherIsConst, typename = typename std::enable_if<IsConst && !OtherIsConst>::type>
+  implicit_tree_iterator(const implicit_tree_iterator<Value, OtherIsConst>& other) noexcept
+    : tree{other.tree}
+    , node{other.node}
+    , position{other.position}
+  {}
+
+  reference operator * () const noexcept {
+    return node->value;
+  }
+
+  pointer operator -> () const noexcept {
+    return &node->value;
+  }
+
+  reference operator [] (difference_type offset) const noexcept {
+    return *(*this + offset);
+  }
+
+  implicit_tree_iterator& operator ++ () noexcept {
+    node = node->next_node();
+    ++position;
+    return *this;
+  }
+
+  implicit_tree_iterator operator ++ (int) noexcept {
+    auto old = *this;
+    ++*this;
+    return old;
+  }
+
+  implicit_tree_iterator& operator -- () noexcept {
+    node = node != nullptr ? node->prev_node() : last_node(tree);
+    --position;
+    return *this;
+  }
+
+  implicit_tree_iterator operator -- (int) noexcept {
+    auto old = *this;
+    --*this;
+    return old;
+  }
+
+  implicit_tree_iterator& operator += (difference_type offset) noexcept {
+    if (-kMaxWalk <= offset && offset <= kMaxWalk) {
+      for (; offset > 0; --offset) {
+        ++*this;
+      }
+      for (; offset < 0; ++offset) {
+        --*this;
+      }
+      return *this;
+    }
+    position = static_cast<size_t>(static_cast<difference_type>(position) + offset);
+    node = node_at(tree, position);
+    return *this;
+  }
+
+  implicit_tree_iterator& operator -= (difference_type offset) noexcept {
+    return *this += -offset;
+  }
+
+  friend implicit_tree_iterator operator + (implicit_tree_iterator it, difference_type offset) noexcept {
+    return it += offset;
+  }
+
+  friend implicit_tree_iterator operator + (difference_type offset, implicit_tree_iterator it) noexcept {
+    return it += offset;
+  }
+
+  friend implicit_tree_iterator operator - (implicit_tree_iterator it, difference_type offset) noexcept {
+    return it -= offset;
+  }
+
+  friend difference_type operator - (const implicit_tree_iterator& lhs, const implicit_tree_iterator& rhs) noexcept {
+    return static_cast<difference_type>(lhs.position) - static_cast<difference_type>(rhs.position);
+  }
+
+  friend bool operator == (const implicit_tree_iterator& lhs, const implicit_tree_iterator& rhs) noexcept {
+    return lhs.position == rhs.position;
+  }
+
+  friend bool operator != (const implicit_tree_iterator& lhs, const implicit_tree_iterator& rhs) noexcept {
+    return lhs.position != rhs.position;
+  }
+
+  friend bool operator < (const implicit_tree_iterator& lhs, const implicit_tree_iterator& rhs) noexcept {
+    return lhs.position < rhs.position;
+  }
+
+  friend bool operator > (const implicit_tree_iterator& lhs, const implicit_tree_iterator& rhs) noexcept {
+    return rhs < lhs;
+  }
+
+  friend bool operator <= (const implicit_tree_iterator& lhs, const implicit_tree_iterator& rhs) noexcept {
+    return !(rhs < lhs);
+  }
+
+  friend bool operator >= (const implicit_tree_iterator& lhs, const implicit_tree_iterator& rhs) noexcept {
+    return !(lhs < rhs);
+  }
+
+ private:
+  template <typename OtherValue, bool OtherIsConst>
+  friend class implicit_tree_iterator;
+
+  // mutable iterators splay the node they jump to
+  static tree_node<Value>* node_at(splay_tree_base<Value>* tree, size_t position) noexcept {
+    return order_statistic_tree(*tree, position);
+  }
+
+  static const tree_node<Value>* node_at(const splay_tree_base<Value>* tree, size_t position) noexcept {
+    return order_statistic_subtree(static_cast<const tree_node<Value>*>(tree->root), position);
+  }
+
+  static tree_node<Value>* last_node(splay_tree_base<Value>* tree) noexcept {
+    auto node = tree->root->rightmost_node();
+    splay_node_tree(*tree, node);
+    return node;
+  }
+
+  static const tree_node<Value>* last_node(const splay_tree_base<Value>* tree) noexcept {
+    return static_cast<const tree_node<Value>*>(tree->root)->rightmost_node();
+  }
+
+  tree_pointer tree;
+  node_pointer node;
+  size_t position;
+};
+
+template <typename Value, bool IsConst>
+constexpr std::ptrdiff_t implicit_tree_iterator<Value, IsConst>::kMaxWalk;
+
+}  // namespace detail
+
 // Splay tree with implicit keys
 template <typename Value>
 class implicit_splay_tree {
@@ -16,6 +194,9 @@ class implicit_splay_tree {
   using base_type = detail::splay_tree_base<Value>;
 
  public:
+  using iterator = detail::implicit_tree_iterator<Value, false>;
+  using const_iterator = detail::implicit_tree_iterator<Value, true>;
+
   implicit_splay_tree()
     : impl{detail::create_tree<Value>()}
   {}
@@ -89,6 +270,72 @@ class implicit_splay_tree {
     return detail::erase_tree(this->impl, node);
   }
 
+  // insert `value` at position `position`, values from it on move one right
+  node_type* insert_at(size_t position, const Value& value) {
+    assert(position <= this->size());
+    auto new_tree = detail::create_tree<Value>(value);
+    const auto node = new_tree.root;
+    auto right_tree = detail::split_right_tree(this->impl, detail::order_statistic_tree(this->impl, position));
+    detail::merge_trees(this->impl, new_tree);
+    detail::merge_trees(this->impl, right_tree);
+    return node;
+  }
+
+  node_type* push_back(const Value& value) {
+    return this->insert(value);
+  }
+
+  // the new node becomes the root with the old tree as its right subtree
+  node_type* push_front(const Value& value) {
+    auto new_tree = detail::create_tree<Value>(value);
+    const auto node = new_tree.root;
+    detail::merge_trees(new_tree, this->impl);
+    detail::swap_trees(this->impl, new_tree);
+    return node;
+  }
+
+  // the ends are splayed to the root, so runs of operations on one end cost
+  // O(1) amortized each
+  Value& front() noexcept {
+    return this->leftmost()->value;
+  }
+
+  Value& back() noexcept {
+    return this->rightmost()->value;
+  }
+
+  void pop_front() noexcept {
+    detail::erase_tree(this->impl, this->leftmost());
+  }
+
+  void pop_back() noexcept {
+    detail::erase_tree(this->impl, this->rightmost());
+  }
+
+  // value at position `position`, the node is splayed to the root
+  Value& operator [] (size_t position) noexcept {
+    assert(position < this->size());
+    return detail::order_statistic_tree(this->impl, position)->value;
+  }
+
+  // the first node is splayed, so begin() costs O(log n) amortized
+  iterator begin() noexcept {
+    return iterator{&this->impl, !this->empty() ? this->leftmost() : nullptr, 0};
+  }
+
+  iterator end() noexcept {
+    return iterator{&this->impl, nullptr, this->size()};
+  }
+
+  const_iterator begin() const noexcept {
+    const node_type* root = this->impl.root;
+    return const_iterator{&this->impl, root != nullptr ? root->leftmost_node() : nullptr, 0};
+  }
+
+  const_iterator end() const noexcept {
+    return const_iterator{&this->impl, nullptr, this->size()};
+  }
+
   self split_left(node_type* node) noexcept {
     auto right_tree = self{};
     right_tree.impl = detail::split_left_tree(this->impl, node);
@@ -105,10 +352,60 @@ class implicit_splay_tree {
     detail::merge_trees(this->impl, rhs.impl);
   }
 
+  // split the tree into `positions.size() + 1` trees, the i-th tree gets the
+  // nodes at positions [positions[i - 1], positions[i]), positions must be
+  // sorted. The tree is left empty
+  std::vector<self> split_at_positions(const std::vector<size_t>& positions) {
+    auto trees = std::vector<self>(positions.size() + 1);
+    auto pieces = detail::split_at_positions_tree(this->impl, positions);
+    for (auto idx = size_t{0}; idx < pieces.size(); ++idx) {
+      trees[idx].impl = pieces[idx];
+    }
+    return trees;
+  }
+
+  // append `trees` in order after the nodes of this tree, `trees` are left empty
+  // trees are merged from the right, so every merge splays the maximum of a
+  // single input tree and the whole join costs O(k log n) amortized
+  void concat(std::vector<self>& trees) {
+    if (trees.empty()) {
+      return;
+    }
+    for (auto idx = trees.size() - 1; idx > 0; --idx) {
+      detail::merge_trees(trees[idx - 1].impl, trees[idx].impl);
+    }
+    detail::merge_trees(this->impl, trees.front().impl);
+  }
+
   node_type* order_statistic(size_t n) noexcept {
     return detail::order_statistic_tree(this->impl, n);
   }
 
+  // nodes at positions `positions` in one traversal without splaying, the
+  // positions are sorted first and the nodes are returned in order, null for
+  // positions not less than the size
+  std::vector<const node_type*> at_ranks(std::vector<size_t> positions) const {
+    std::sort(std::begin(positions), std::end(positions));
+    return detail::order_statistics_subtree(static_cast<const node_type*>(this->impl.root), positions);
+  }
+
+  // `k` nodes drawn uniformly with replacement, in order
+  // the tree is not splayed, so sampling doesn't change its shape
+  template <typename RandomGenerator>
+  std::vector<const node_type*> sample(size_t k, RandomGenerator& generator) const {
+    return this->sample_range(0, this->size(), k, generator);
+  }
+
+  // `k` nodes at positions in [first, last) drawn uniformly with replacement
+  template <typename RandomGenerator>
+  std::vector<const node_type*> sample_range(
+      size_t first, size_t last, size_t k, RandomGenerator& generator) const {
+    last = last < this->size() ? last : this->size();
+    return detail::order_statistics_subtree(
+      static_cast<const node_type*>(this->impl.root),
+      detail::sample_ranks(first, last, k, generator));
+  }
+
   void swap(self& other) noexcept {
     auto* const tree = this;
     detail::swap_trees(tree->impl, other.impl);
@@ -122,6 +419,20 @@ class implicit_splay_tree {
   friend std::ostream& operator << (std::ostream& out, const implicit_splay_tree<Value_>& tree);
 
  private:
+  node_type* leftmost() noexcept {
+    assert(!this->empty());
+    auto node = this->impl.root->leftmost_node();
+    detail::splay_node_tree(this->impl, node);
+    return node;
+  }
+
+  node_type* rightmost() noexcept {
+    assert(!this->empty());
+    auto node = this->impl.root->rightmost_node();
+    detail::splay_node_tree(this->impl, node);
+    return node;
+  }
+
   base_type impl;
 };
 
@@ -0,0 +1,201 @@
+#ifndef SPLAY_TREE_INTERVAL_MAP_H_
+#define SPLAY_TREE_INTERVAL_MAP_H_
+
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+// half-open interval [start, end) mapped to `value`
+template <typename Key, typename Value>
+struct mapped_interval {
+  Key start;
+  Key end;
+  Value value;
+};
+
+template <typename Key, typename Value>
+std::ostream& operator << (std::ostream& out, const mapped_interval<Key, Value>& interval) {
+  out << "[" << interval.start << ", " << interval.end << ")->" << interval.value;
+  return out;
+}
+
+// Map from disjoint half-open key intervals to values. Adjacent intervals
+// mapped to equal values are always coalesced into one. Intervals are kept in
+// a splay tree keyed by the interval start, updates cut the affected key range
+// out with two splits, so assigning or erasing a range costs O(log n + k)
+// amortized where `k` is the number of intervals it covers
+template <typename Key, typename Value, typename KeyComparator = std::less<Key>>
+class interval_map {
+  using interval_type = mapped_interval<Key, Value>;
+
+  struct start_extractor {
+    const Key& operator () (const interval_type& interval) const noexcept {
+      return interval.start;
+    }
+  };
+
+ public:
+  using tree_type = splay_tree<Key, interval_type, KeyComparator, start_extractor>;
+  using node_type = tree_node<interval_type>;
+
+  interval_map()
+    : interval_map(KeyComparator{})
+  {}
+
+  explicit interval_map(const KeyComparator& comparator)
+    : tree{comparator, start_extractor{}}
+    , comparator{comparator}
+  {}
+
+  // number of disjoint intervals
+  size_t size() const noexcept {
+    return tree.size();
+  }
+
+  bool empty() const noexcept {
+    return tree.empty();
+  }
+
+  void clear() noexcept {
+    tree.clear();
+  }
+
+  // map every key of [low, high) to `value`
+  void assign(const Key& low, const Key& high, const Value& value) {
+    if (!comparator(low, high)) {
+      return;
+    }
+    auto right = this->cut(low, high);
+    auto& left = tree;
+    auto before = !left.empty() ? this->splay_rightmost(left) : nullptr;
+    auto after = !right.empty() ? this->splay_leftmost(right) : nullptr;
+    const auto joins_before = (
+      before != nullptr && !comparator(before->value.end, low) && before->value.value == value);
+    const auto joins_after = (
+      after != nullptr && !comparator(high, after->value.start) && after->value.value == value);
+    if (joins_before) {
+      before->value.end = high;
+      if (joins_after) {
+        before->value.end = after->value.end;
+        right.erase(after);
+      }
+    } else if (joins_after) {
+      after->value.start = low;
+    } else {
+      auto middle = tree_type{comparator, start_extractor{}};
+      middle.insert(interval_type{low, high, value});
+      left.merge(middle);
+    }
+    left.merge(right);
+  }
+
+  // remove every key of [low, high) from the map
+  void erase(const Key& low, const Key& high) {
+    if (!comparator(low, high)) {
+      return;
+    }
+    auto right = this->cut(low, high);
+    tree.merge(right);
+  }
+
+  // value mapped to `key`, null if `key` is not covered by any interval
+  const Value* find(const Key& key) {
+    auto interval = this->find_interval(key);
+    return interval != nullptr ? std::addressof(interval->value) : nullptr;
+  }
+
+  // interval containing `key`, null if there is none
+  const interval_type* find_interval(const Key& key) {
+    auto node = this->containing_or_next(key);
+    if (node == nullptr || comparator(key, node->value.start)) {
+      return nullptr;
+    }
+    return std::addressof(node->value);
+  }
+
+  // call `visitor` for every interval intersecting [low, high) in key order
+  template <typename Visitor>
+  void for_each_overlap(const Key& low, const Key& high, Visitor visitor) {
+    if (!comparator(low, high)) {
+      return;
+    }
+    const node_type* node = this->containing_or_next(low);
+    while (node != nullptr && comparator(node->value.start, high)) {
+      visitor(node->value);
+      node = node->next_node();
+    }
+  }
+
+  const tree_type& get_tree() const noexcept {
+    return tree;
+  }
+
+ private:
+  node_type* splay_rightmost(tree_type& part) noexcept {
+    auto node = part.root()->rightmost_node();
+    part.splay(node);
+    return node;
+  }
+
+  node_type* splay_leftmost(tree_type& part) noexcept {
+    auto node = part.root()->leftmost_node();
+    part.splay(node);
+    return node;
+  }
+
+  // the interval containing `key` if there is one, otherwise the first
+  // interval starting after `key`
+  node_type* containing_or_next(const Key& key) {
+    auto next = tree.upper_bound(key);
+    auto prev = next != nullptr ? next->prev_node() : (
+      !tree.empty() ? tree.root()->rightmost_node() : nullptr);
+    if (prev != nullptr && comparator(key, prev->value.end)) {
+      tree.splay(prev);
+      return prev;
+    }
+    return next;
+  }
+
+  // remove keys [low, high) from the map, `tree` keeps the intervals before
+  // `low`, the intervals after `high` are returned
+  tree_type cut(const Key& low, const Key& high) {
+    auto middle_right = tree.split_right(tree.lower_bound(low));
+    auto& left = tree;
+    auto right = middle_right.split_right(middle_right.lower_bound(high));
+    auto& middle = middle_right;
+    // interval sticking out of the middle part to the right
+    auto tail = static_cast<const interval_type*>(nullptr);
+    if (!middle.empty()) {
+      tail = std::addressof(this->splay_rightmost(middle)->value);
+    }
+    if (!left.empty()) {
+      auto before = this->splay_rightmost(left);
+      if (comparator(high, before->value.end)) {
+        tail = std::addressof(before->value);
+      }
+    }
+    if (tail != nullptr && comparator(high, tail->end)) {
+      right.insert(interval_type{high, tail->end, tail->value});
+    }
+    if (!left.empty()) {
+      auto before = left.root();
+      if (comparator(low, before->value.end)) {
+        before->value.end = low;
+      }
+    }
+    middle.clear();
+    return right;
+  }
+
+  tree_type tree;
+  KeyComparator comparator;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_INTERVAL_MAP_H_
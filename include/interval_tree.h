@@ -0,0 +1,153 @@
+#ifndef SPLAY_TREE_INTERVAL_TREE_H_
+#define SPLAY_TREE_INTERVAL_TREE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+// Closed interval [start, end] with a payload. Every node also stores the
+// largest `end` in its subtree, which lets searches skip subtrees whose
+// intervals all end before the query. `id` tells apart equal intervals
+template <typename Key, typename Payload>
+struct interval_value {
+  interval_value(const Key& start, const Key& end, const Payload& payload, uint64_t id)
+    : start{start}
+    , end{end}
+    , payload{payload}
+    , id{id}
+    , max_end{end}
+  {}
+
+  Key start;
+  Key end;
+  Payload payload;
+  uint64_t id;
+  Key max_end;
+};
+
+template <typename Key, typename Payload>
+std::ostream& operator << (std::ostream& out, const interval_value<Key, Payload>& interval) {
+  out << "[" << interval.start << ", " << interval.end << "]";
+  return out;
+}
+
+template <typename Key, typename Payload>
+struct node_augmentation<interval_value<Key, Payload>> {
+  static void update(tree_node<interval_value<Key, Payload>>* node) noexcept {
+    auto& value = node->value;
+    value.max_end = value.end;
+    if (node->left != nullptr && value.max_end < node->left->value.max_end) {
+      value.max_end = node->left->value.max_end;
+    }
+    if (node->right != nullptr && value.max_end < node->right->value.max_end) {
+      value.max_end = node->right->value.max_end;
+    }
+  }
+};
+
+// Set of closed intervals ordered by start, answering stabbing and overlap
+// queries. Searches descend only into subtrees whose `max_end` reaches the
+// query and whose starts don't exceed it. Reaching every reported interval
+// may take a path of O(depth) nodes, so a query reporting `k` intervals
+// visits O(min(n, (k + 1) * depth)) nodes.
+// The last node the search descended to is splayed afterwards to pay for the
+// descent
+template <typename Key, typename Payload>
+class interval_tree {
+  using value_type = interval_value<Key, Payload>;
+
+  struct interval_key_extractor {
+    std::pair<Key, uint64_t> operator () (const value_type& value) const {
+      return std::make_pair(value.start, value.id);
+    }
+  };
+
+ public:
+  using tree_type = splay_tree<
+    std::pair<Key, uint64_t>, value_type, std::less<std::pair<Key, uint64_t>>,
+    interval_key_extractor>;
+  using node_type = tree_node<value_type>;
+
+  interval_tree()
+    : tree{}
+    , next_id{0}
+  {}
+
+  size_t size() const noexcept {
+    return tree.size();
+  }
+
+  bool empty() const noexcept {
+    return tree.empty();
+  }
+
+  void clear() noexcept {
+    tree.clear();
+  }
+
+  // insert interval [start, end], the returned node stays valid until erased
+  node_type* insert(const Key& start, const Key& end, const Payload& payload) {
+    assert(!(end < start));
+    return tree.insert(value_type{start, end, payload, next_id++});
+  }
+
+  void erase(node_type* node) noexcept {
+    tree.erase(node);
+  }
+
+  // call `visitor` for every interval containing `point`
+  template <typename Visitor>
+  void for_each_containing(const Key& point, Visitor visitor) {
+    this->for_each_overlap(point, point, visitor);
+  }
+
+  // call `visitor` for every interval intersecting [low, high] in start order
+  template <typename Visitor>
+  void for_each_overlap(const Key& low, const Key& high, Visitor visitor) {
+    // in-order walk pruned by max_end (left and current) and start (right)
+    auto pending = std::vector<node_type*>{};
+    auto last_descended = static_cast<node_type*>(nullptr);
+    auto node = tree.root();
+    while (node != nullptr || !pending.empty()) {
+      while (node != nullptr && !(node->value.max_end < low)) {
+        pending.push_back(node);
+        last_descended = node;
+        node = node->left;
+      }
+      if (pending.empty()) {
+        break;
+      }
+      node = pending.back();
+      pending.pop_back();
+      if (high < node->value.start) {
+        break;
+      }
+      if (!(node->value.end < low)) {
+        visitor(static_cast<const value_type&>(node->value));
+      }
+      node = node->right;
+    }
+    if (last_descended != nullptr) {
+      tree.splay(last_descended);
+    }
+  }
+
+  const tree_type& get_tree() const noexcept {
+    return tree;
+  }
+
+ private:
+  tree_type tree;
+  uint64_t next_id;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_INTERVAL_TREE_H_
@@ -0,0 +1,402 @@
+#ifndef SPLAY_TREE_LSM_INDEX_H_
+#define SPLAY_TREE_LSM_INDEX_H_
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+// value of a key or a tombstone hiding older values of the key
+template <typename Key, typename Value>
+struct lsm_entry {
+  Key key;
+  Value value;
+  bool tombstone;
+};
+
+template <typename Key, typename Value>
+std::ostream& operator << (std::ostream& out, const lsm_entry<Key, Value>& entry) {
+  out << entry.key;
+  if (entry.tombstone) {
+    out << "(deleted)";
+  }
+  return out;
+}
+
+// Write optimized ordered map. Writes go to a small splay tree memtable; once
+// it holds `memtable_limit` keys it is frozen and a background thread turns
+// it into an immutable sorted run. Runs are merged while a newer run is at
+// least half as large as the next older one, so there are O(log n) runs of
+// geometrically growing sizes and every entry is rewritten O(log n) times.
+// Erasing writes a tombstone, tombstones are dropped when they reach the
+// oldest run. Lookups consult the memtable, the frozen memtables and the runs
+// from newest to oldest, the first entry of a key wins. All members may be
+// called from several threads
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class lsm_index {
+  using entry_type = lsm_entry<Key, Value>;
+  using node_type = tree_node<entry_type>;
+
+  struct entry_key_extractor {
+    const Key& operator () (const entry_type& entry) const noexcept {
+      return entry.key;
+    }
+  };
+
+  using memtable_type = splay_tree<Key, entry_type, Compare, entry_key_extractor>;
+  using run_type = std::vector<entry_type>;
+  using frozen_pointer = std::shared_ptr<const memtable_type>;
+  using run_pointer = std::shared_ptr<const run_type>;
+
+  // frozen memtables waiting for the background thread before writers block
+  static constexpr size_t kMaxFrozen = 4;
+
+  // sorted entries of one level in [low, high], either a range of an array or
+  // an in-order walk of a frozen memtable
+  struct cursor {
+    const entry_type* position;
+    const entry_type* end;
+    const node_type* node;
+  };
+
+ public:
+  explicit lsm_index(size_t memtable_limit = size_t{1} << 16, const Compare& compare = Compare{})
+    : comparator{compare}
+    , memtable{compare, entry_key_extractor{}}
+    , frozen{}
+    , runs{}
+    , memtable_limit{memtable_limit}
+    , stopping{false}
+    , mutex{}
+    , work_available{}
+    , work_done{}
+    , worker{}
+  {
+    assert(memtable_limit != 0);
+    worker = std::thread{[this]() {
+      this->merge_loop();
+    }};
+  }
+
+  // the background thread refers to the index, so it can't be copied or moved
+  lsm_index(const lsm_index& other) = delete;
+  lsm_index& operator = (const lsm_index& other) = delete;
+
+  ~lsm_index() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      stopping = true;
+    }
+    work_available.notify_all();
+    worker.join();
+  }
+
+  // set the value of `key`
+  void put(const Key& key, const Value& value) {
+    this->write(entry_type{key, value, false});
+  }
+
+  // remove `key`, older values of the key are hidden by a tombstone
+  void erase(const Key& key) {
+    this->write(entry_type{key, Value{}, true});
+  }
+
+  // copy the value of `key` into `value`, returns false if the key is missing
+  bool find(const Key& key, Value& value) {
+    auto lock = std::unique_lock<std::mutex>{mutex};
+    auto node = memtable.find(key);
+    if (node != nullptr) {
+      return this->read(node->value, value);
+    }
+    const auto frozen_tables = frozen;
+    const auto current_runs = runs;
+    lock.unlock();
+    const auto extractor = entry_key_extractor{};
+    for (auto it = frozen_tables.rbegin(); it != frozen_tables.rend(); ++it) {
+      const node_type* bound = detail::lower_bound_subtree(
+        const_cast<node_type*>((*it)->root()), key, comparator, extractor);
+      if (bound != nullptr && !comparator(key, bound->value.key)) {
+        return this->read(bound->value, value);
+      }
+    }
+    for (const auto& run : current_runs) {
+      auto bound = std::lower_bound(std::begin(*run), std::end(*run), key,
+        [this](const entry_type& entry, const Key& probe) {
+          return comparator(entry.key, probe);
+        });
+      if (bound != std::end(*run) && !comparator(key, bound->key)) {
+        return this->read(*bound, value);
+      }
+    }
+    return false;
+  }
+
+  bool contains(const Key& key) {
+    auto value = Value{};
+    return this->find(key, value);
+  }
+
+  // number of keys in [low, high], walks all levels over the range
+  size_t count_range(const Key& low, const Key& high) {
+    auto count = size_t{0};
+    this->scan(&low, &high, [&count](const Key&, const Value&) {
+      ++count;
+    });
+    return count;
+  }
+
+  // call `visitor(key, value)` for every key in [low, high] in key order
+  template <typename Visitor>
+  void for_each_range(const Key& low, const Key& high, Visitor visitor) {
+    this->scan(&low, &high, visitor);
+  }
+
+  // call `visitor(key, value)` for every key in key order
+  template <typename Visitor>
+  void for_each(Visitor visitor) {
+    this->scan(nullptr, nullptr, visitor);
+  }
+
+  // freeze the memtable and wait until all frozen memtables are merged
+  void flush() {
+    auto lock = std::unique_lock<std::mutex>{mutex};
+    if (!memtable.empty()) {
+      this->freeze();
+    }
+    work_done.wait(lock, [this]() {
+      return frozen.empty();
+    });
+  }
+
+  size_t memtable_size() {
+    std::lock_guard<std::mutex> lock{mutex};
+    return memtable.size();
+  }
+
+  size_t run_count() {
+    std::lock_guard<std::mutex> lock{mutex};
+    return runs.size();
+  }
+
+  // entries in all runs including tombstones and shadowed values
+  size_t run_entries() {
+    std::lock_guard<std::mutex> lock{mutex};
+    auto count = size_t{0};
+    for (const auto& run : runs) {
+      count += run->size();
+    }
+    return count;
+  }
+
+ private:
+  bool read(const entry_type& entry, Value& value) const {
+    if (entry.tombstone) {
+      return false;
+    }
+    value = entry.value;
+    return true;
+  }
+
+  void write(const entry_type& entry) {
+    auto lock = std::unique_lock<std::mutex>{mutex};
+    // let the background thread catch up instead of piling up memtables
+    work_done.wait(lock, [this]() {
+      return frozen.size() < kMaxFrozen;
+    });
+    auto node = memtable.find(entry.key);
+    if (node != nullptr) {
+      node->value = entry;
+    } else {
+      memtable.insert(entry);
+    }
+    if (memtable.size() >= memtable_limit) {
+      this->freeze();
+    }
+  }
+
+  // called with the mutex held
+  void freeze() {
+    frozen.push_back(std::make_shared<const memtable_type>(std::move(memtable)));
+    memtable = memtable_type{comparator, entry_key_extractor{}};
+    work_available.notify_one();
+  }
+
+  void merge_loop() {
+    auto lock = std::unique_lock<std::mutex>{mutex};
+    while (true) {
+      work_available.wait(lock, [this]() {
+        return stopping || !frozen.empty();
+      });
+      if (stopping) {
+        return;
+      }
+      const auto table = frozen.front();
+      auto merged = runs;
+      lock.unlock();
+      this->add_run(*table, merged);
+      lock.lock();
+      runs = std::move(merged);
+      frozen.pop_front();
+      work_done.notify_all();
+    }
+  }
+
+  // turn `table` into the newest run of `levels` and merge runs while the
+  // newer one is at least half as large as the older one
+  void add_run(const memtable_type& table, std::vector<run_pointer>& levels) const {
+    auto run = std::make_shared<run_type>();
+    run->reserve(table.size());
+    for (const node_type* node = table.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      if (!levels.empty() || !node->value.tombstone) {
+        run->push_back(node->value);
+      }
+    }
+    levels.insert(std::begin(levels), std::move(run));
+    while (levels.size() >= 2 && 2 * levels[0]->size() >= levels[1]->size()) {
+      const auto bottom = levels.size() == 2;
+      auto combined = this->merge_runs(*levels[0], *levels[1], bottom);
+      levels.erase(std::begin(levels), std::begin(levels) + 2);
+      levels.insert(std::begin(levels), std::move(combined));
+    }
+  }
+
+  // merge sorted runs, entries of `newer` win, tombstones are dropped from the
+  // oldest run since there is nothing left for them to hide
+  run_pointer merge_runs(const run_type& newer, const run_type& older, bool bottom) const {
+    auto merged = std::make_shared<run_type>();
+    merged->reserve(newer.size() + older.size());
+    auto append = [&merged, bottom](const entry_type& entry) {
+      if (!bottom || !entry.tombstone) {
+        merged->push_back(entry);
+      }
+    };
+    auto lhs = std::begin(newer);
+    auto rhs = std::begin(older);
+    while (lhs != std::end(newer) && rhs != std::end(older)) {
+      if (comparator(lhs->key, rhs->key)) {
+        append(*lhs++);
+      } else if (comparator(rhs->key, lhs->key)) {
+        append(*rhs++);
+      } else {
+        append(*lhs++);
+        ++rhs;
+      }
+    }
+    std::for_each(lhs, std::end(newer), append);
+    std::for_each(rhs, std::end(older), append);
+    merged->shrink_to_fit();
+    return merged;
+  }
+
+  // entries of all levels with keys in [low, high] (null for unbounded)
+  // merged in key order, the newest entry of a key wins
+  template <typename Visitor>
+  void scan(const Key* low, const Key* high, Visitor visitor) {
+    const auto extractor = entry_key_extractor{};
+    auto active = run_type{};
+    auto lock = std::unique_lock<std::mutex>{mutex};
+    if (!memtable.empty()) {
+      auto node = low != nullptr ? memtable.lower_bound(*low) : memtable.root()->leftmost_node();
+      for (; node != nullptr && (high == nullptr || !comparator(*high, node->value.key)); node = node->next_node()) {
+        active.push_back(node->value);
+      }
+    }
+    const auto frozen_tables = frozen;
+    const auto current_runs = runs;
+    lock.unlock();
+    // cursors from the newest level to the oldest
+    auto cursors = std::vector<cursor>{};
+    cursors.push_back(cursor{active.data(), active.data() + active.size(), nullptr});
+    for (auto it = frozen_tables.rbegin(); it != frozen_tables.rend(); ++it) {
+      const node_type* root = (*it)->root();
+      const node_type* first = low != nullptr
+        ? detail::lower_bound_subtree(const_cast<node_type*>(root), *low, comparator, extractor)
+        : (root != nullptr ? root->leftmost_node() : nullptr);
+      cursors.push_back(cursor{nullptr, nullptr, first});
+    }
+    for (const auto& run : current_runs) {
+      auto first = low != nullptr
+        ? std::lower_bound(std::begin(*run), std::end(*run), *low,
+            [this](const entry_type& entry, const Key& probe) {
+              return comparator(entry.key, probe);
+            })
+        : std::begin(*run);
+      cursors.push_back(cursor{run->data() + (first - std::begin(*run)), run->data() + run->size(), nullptr});
+    }
+    while (true) {
+      const entry_type* next = nullptr;
+      for (const auto& item : cursors) {
+        const auto entry = this->current(item, high);
+        // on equal keys the earlier, newer cursor is kept
+        if (entry != nullptr && (next == nullptr || comparator(entry->key, next->key))) {
+          next = entry;
+        }
+      }
+      if (next == nullptr) {
+        return;
+      }
+      const auto key = next->key;
+      if (!next->tombstone) {
+        visitor(next->key, next->value);
+      }
+      for (auto& item : cursors) {
+        const auto entry = this->current(item, high);
+        if (entry != nullptr && !comparator(key, entry->key)) {
+          this->advance(item);
+        }
+      }
+    }
+  }
+
+  const entry_type* current(const cursor& item, const Key* high) const {
+    const entry_type* entry = nullptr;
+    if (item.node != nullptr) {
+      entry = &item.node->value;
+    } else if (item.position != item.end) {
+      entry = item.position;
+    }
+    if (entry != nullptr && high != nullptr && comparator(*high, entry->key)) {
+      return nullptr;
+    }
+    return entry;
+  }
+
+  void advance(cursor& item) const noexcept {
+    if (item.node != nullptr) {
+      item.node = item.node->next_node();
+    } else {
+      ++item.position;
+    }
+  }
+
+  Compare comparator;
+  memtable_type memtable;
+  std::deque<frozen_pointer> frozen;
+  // newest run first
+  std::vector<run_pointer> runs;
+  size_t memtable_limit;
+  bool stopping;
+  std::mutex mutex;
+  std::condition_variable work_available;
+  std::condition_variable work_done;
+  std::thread worker;
+};
+
+template <typename Key, typename Value, typename Compare>
+constexpr size_t lsm_index<Key, Value, Compare>::kMaxFrozen;
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_LSM_INDEX_H_
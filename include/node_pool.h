@@ -0,0 +1,122 @@
+#ifndef SPLAY_TREE_NODE_POOL_H_
+#define SPLAY_TREE_NODE_POOL_H_
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "tree_node.h"
+
+namespace splay {
+
+// Free list of detached nodes. Nodes released to the pool are handed out again
+// by `acquire` instead of going through the allocator. The pool keeps at most
+// `max_size` nodes, further released nodes are destroyed. Values that can be
+// reset without throwing are replaced by a default value on release, so
+// pooled nodes don't hold on to buffers of their old values
+template <typename Value>
+class node_pool {
+  using self = node_pool<Value>;
+  using node_type = tree_node<Value>;
+
+ public:
+  explicit node_pool(size_t max_size = std::numeric_limits<size_t>::max()) noexcept
+    : free_list{nullptr}
+    , free_count{0}
+    , max_size{max_size}
+  {}
+
+  node_pool(const self& other) = delete;
+
+  node_pool(self&& other) noexcept
+    : node_pool{} {
+    this->swap(other);
+  }
+
+  self& operator = (const self& other) = delete;
+
+  self& operator = (self&& other) noexcept {
+    this->swap(other);
+    return *this;
+  }
+
+  ~node_pool() {
+    this->clear();
+  }
+
+  // return a detached node holding `value`
+  node_type* acquire(const Value& value) {
+    if (free_list == nullptr) {
+      return detail::create_node(value);
+    }
+    auto node = free_list;
+    free_list = node->right;
+    --free_count;
+    node->right = nullptr;
+    node->value = value;
+    node->size = uint64_t{1};
+    node_augmentation<Value>::update(node);
+    return node;
+  }
+
+  // put detached node `node` to the pool, or destroy it if the pool is full
+  void release(node_type* node) noexcept {
+    assert(node != nullptr);
+    assert(node->parent == nullptr && node->left == nullptr && node->right == nullptr);
+    if (free_count >= max_size) {
+      detail::destroy_node(node);
+      return;
+    }
+    reset_value(node, std::integral_constant<bool,
+      std::is_nothrow_default_constructible<Value>::value &&
+      std::is_nothrow_move_constructible<Value>::value &&
+      std::is_nothrow_move_assignable<Value>::value>{});
+    node->right = free_list;
+    free_list = node;
+    ++free_count;
+  }
+
+  size_t size() const noexcept {
+    return free_count;
+  }
+
+  size_t capacity() const noexcept {
+    return max_size;
+  }
+
+  void swap(self& other) noexcept {
+    std::swap(free_list, other.free_list);
+    std::swap(free_count, other.free_count);
+    std::swap(max_size, other.max_size);
+  }
+
+  void clear() noexcept {
+    while (free_list != nullptr) {
+      auto node = free_list;
+      free_list = node->right;
+      node->right = nullptr;
+      detail::destroy_node(node);
+    }
+    free_count = 0;
+  }
+
+ private:
+  // swap the old value out so its buffers are freed with `stale`, assigning
+  // a default value could keep the old capacity
+  static void reset_value(node_type* node, std::true_type) noexcept {
+    auto stale = Value{};
+    std::swap(stale, node->value);
+  }
+
+  static void reset_value(node_type*, std::false_type) noexcept {}
+
+  node_type* free_list;
+  size_t free_count;
+  size_t max_size;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_NODE_POOL_H_
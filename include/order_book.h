@@ -0,0 +1,340 @@
+#ifndef SPLAY_TREE_ORDER_BOOK_H_
+#define SPLAY_TREE_ORDER_BOOK_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+enum class order_side : uint32_t {
+  kBuy,
+  kSell
+};
+
+struct price_level;
+
+// Resting order, linked into the FIFO queue of its price level
+struct book_order {
+  uint64_t id;
+  order_side side;
+  int64_t price;
+  uint64_t quantity;
+  book_order* prev;
+  book_order* next;
+  tree_node<price_level>* level;
+};
+
+// All resting orders of one side at one price in time priority
+struct price_level {
+  int64_t price;
+  uint64_t quantity;
+  uint64_t order_count;
+  book_order* head;
+  book_order* tail;
+};
+
+inline std::ostream& operator << (std::ostream& out, const price_level& level) {
+  out << level.price << "x" << level.quantity;
+  return out;
+}
+
+struct book_trade {
+  uint64_t maker_id;
+  uint64_t taker_id;
+  int64_t price;
+  uint64_t quantity;
+};
+
+namespace detail {
+
+struct level_price_extractor {
+  int64_t operator () (const price_level& level) const noexcept {
+    return level.price;
+  }
+};
+
+// Price levels of one side of the book ordered from the best price, so the
+// best level is the leftmost node and the level of rank `n` is the `n`-th
+// order statistic. Trading concentrates near the best price, splaying keeps
+// those levels next to the root
+template <typename PriceComparator>
+class book_side {
+ public:
+  using tree_type = splay_tree<int64_t, price_level, PriceComparator, level_price_extractor>;
+  using node_type = tree_node<price_level>;
+
+  size_t size() const noexcept {
+    return levels.size();
+  }
+
+  bool empty() const noexcept {
+    return levels.empty();
+  }
+
+  node_type* best() noexcept {
+    if (levels.empty()) {
+      return nullptr;
+    }
+    auto node = levels.root()->leftmost_node();
+    levels.splay(node);
+    return node;
+  }
+
+  node_type* level(size_t rank) noexcept {
+    return levels.order_statistic(rank);
+  }
+
+  node_type* find(int64_t price) {
+    return levels.find(price);
+  }
+
+  void append(book_order* order) {
+    auto node = levels.find(order->price);
+    if (node == nullptr) {
+      node = levels.insert(price_level{order->price, 0, 0, nullptr, nullptr});
+    }
+    auto& level = node->value;
+    order->level = node;
+    order->prev = level.tail;
+    order->next = nullptr;
+    if (level.tail != nullptr) {
+      level.tail->next = order;
+    } else {
+      level.head = order;
+    }
+    level.tail = order;
+    level.quantity += order->quantity;
+    ++level.order_count;
+  }
+
+  // unlink `order` from its level, the level is erased once it is empty
+  void remove(book_order* order) noexcept {
+    auto node = order->level;
+    auto& level = node->value;
+    if (order->prev != nullptr) {
+      order->prev->next = order->next;
+    } else {
+      level.head = order->next;
+    }
+    if (order->next != nullptr) {
+      order->next->prev = order->prev;
+    } else {
+      level.tail = order->prev;
+    }
+    level.quantity -= order->quantity;
+    --level.order_count;
+    order->prev = nullptr;
+    order->next = nullptr;
+    order->level = nullptr;
+    if (level.order_count == 0) {
+      levels.erase(node);
+    }
+  }
+
+  const tree_type& get_tree() const noexcept {
+    return levels;
+  }
+
+ private:
+  tree_type levels;
+};
+
+}  // namespace detail
+
+// Limit order book with price-time priority. Each side keeps its price levels
+// in a splay tree, orders live in FIFO queues of their levels and are found by
+// id through a hash map. Incoming orders match against the opposite side first
+// and the remainder rests in the book
+class order_book {
+  using bid_side = detail::book_side<std::greater<int64_t>>;
+  using ask_side = detail::book_side<std::less<int64_t>>;
+
+ public:
+  order_book()
+    : bids{}
+    , asks{}
+    , orders{}
+    , volume{0}
+  {}
+
+  // orders point to levels and to each other, so the book can't be copied
+  order_book(const order_book& other) = delete;
+  order_book(order_book&& other) = default;
+  order_book& operator = (const order_book& other) = delete;
+  order_book& operator = (order_book&& other) = default;
+
+  size_t size() const noexcept {
+    return orders.size();
+  }
+
+  // number of price levels on `side`
+  size_t depth(order_side side) const noexcept {
+    return side == order_side::kBuy ? bids.size() : asks.size();
+  }
+
+  // total traded quantity
+  uint64_t traded_volume() const noexcept {
+    return volume;
+  }
+
+  // match a limit order against the book and rest the remainder
+  // returns the resting order or null if the order was filled completely
+  // `on_trade` is called with `book_trade` for every fill
+  template <typename TradeHandler>
+  book_order* add(
+      uint64_t id, order_side side, int64_t price, uint64_t quantity, TradeHandler on_trade) {
+    assert(orders.find(id) == orders.end());
+    if (side == order_side::kBuy) {
+      quantity = this->match(asks, id, quantity, on_trade,
+        [price](int64_t level_price) { return level_price <= price; });
+    } else {
+      quantity = this->match(bids, id, quantity, on_trade,
+        [price](int64_t level_price) { return level_price >= price; });
+    }
+    if (quantity == 0) {
+      return nullptr;
+    }
+    auto& order = orders[id];
+    order = book_order{id, side, price, quantity, nullptr, nullptr, nullptr};
+    if (side == order_side::kBuy) {
+      bids.append(&order);
+    } else {
+      asks.append(&order);
+    }
+    return &order;
+  }
+
+  book_order* add(uint64_t id, order_side side, int64_t price, uint64_t quantity) {
+    return this->add(id, side, price, quantity, [](const book_trade&) {});
+  }
+
+  book_order* find(uint64_t id) {
+    auto it = orders.find(id);
+    return it != orders.end() ? &it->second : nullptr;
+  }
+
+  // remove resting order `order`, the handle is invalid afterwards
+  void cancel(book_order* order) {
+    assert(order != nullptr);
+    const auto id = order->id;
+    this->unlink(order);
+    orders.erase(id);
+  }
+
+  bool cancel(uint64_t id) {
+    auto order = this->find(id);
+    if (order == nullptr) {
+      return false;
+    }
+    this->cancel(order);
+    return true;
+  }
+
+  // cancel `quantity` of the resting order `id` keeping its time priority
+  bool reduce(uint64_t id, uint64_t quantity) {
+    auto order = this->find(id);
+    if (order == nullptr) {
+      return false;
+    }
+    if (quantity >= order->quantity) {
+      this->cancel(order);
+    } else {
+      order->quantity -= quantity;
+      order->level->value.quantity -= quantity;
+    }
+    return true;
+  }
+
+  // resting order `id` traded `quantity` outside of this book
+  bool execute(uint64_t id, uint64_t quantity) {
+    auto order = this->find(id);
+    if (order == nullptr) {
+      return false;
+    }
+    volume += quantity < order->quantity ? quantity : order->quantity;
+    return this->reduce(id, quantity);
+  }
+
+  // cancel order `id` and add order `new_id` on the same side, losing priority
+  book_order* replace(uint64_t id, uint64_t new_id, int64_t price, uint64_t quantity) {
+    auto order = this->find(id);
+    if (order == nullptr) {
+      return nullptr;
+    }
+    const auto side = order->side;
+    this->cancel(order);
+    return this->add(new_id, side, price, quantity);
+  }
+
+  // best price level of `side`, null if the side is empty
+  const price_level* best(order_side side) noexcept {
+    auto node = side == order_side::kBuy ? bids.best() : asks.best();
+    return node != nullptr ? &node->value : nullptr;
+  }
+
+  // price level of rank `rank` (0 is the best) on `side`, null if there is none
+  const price_level* level(order_side side, size_t rank) noexcept {
+    auto node = side == order_side::kBuy ? bids.level(rank) : asks.level(rank);
+    return node != nullptr ? &node->value : nullptr;
+  }
+
+  // total quantity of the `levels` best price levels of `side`
+  uint64_t depth_quantity(order_side side, size_t levels) noexcept {
+    auto total = uint64_t{0};
+    auto node = static_cast<const tree_node<price_level>*>(
+      side == order_side::kBuy ? bids.best() : asks.best());
+    for (auto idx = size_t{0}; idx < levels && node != nullptr; ++idx) {
+      total += node->value.quantity;
+      node = node->next_node();
+    }
+    return total;
+  }
+
+ private:
+  void unlink(book_order* order) noexcept {
+    if (order->side == order_side::kBuy) {
+      bids.remove(order);
+    } else {
+      asks.remove(order);
+    }
+  }
+
+  template <typename Side, typename TradeHandler, typename Crosses>
+  uint64_t match(
+      Side& side, uint64_t taker_id, uint64_t quantity, TradeHandler& on_trade, Crosses crosses) {
+    while (quantity != 0) {
+      auto node = side.best();
+      if (node == nullptr || !crosses(node->value.price)) {
+        break;
+      }
+      auto maker = node->value.head;
+      const auto fill = quantity < maker->quantity ? quantity : maker->quantity;
+      on_trade(book_trade{maker->id, taker_id, maker->price, fill});
+      volume += fill;
+      quantity -= fill;
+      if (fill == maker->quantity) {
+        const auto maker_id = maker->id;
+        side.remove(maker);
+        orders.erase(maker_id);
+      } else {
+        maker->quantity -= fill;
+        node->value.quantity -= fill;
+      }
+    }
+    return quantity;
+  }
+
+  bid_side bids;
+  ask_side asks;
+  std::unordered_map<uint64_t, book_order> orders;
+  uint64_t volume;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_ORDER_BOOK_H_
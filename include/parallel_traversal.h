@@ -0,0 +1,144 @@
+#ifndef SPLAY_TREE_PARALLEL_TRAVERSAL_H_
+#define SPLAY_TREE_PARALLEL_TRAVERSAL_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+namespace detail {
+
+// Run `visit(chunk, first, last)` for `chunks` slices of equal rank of the
+// nodes with ranks in [first, last), each slice on its own thread and the
+// first one on the calling thread. The first exception thrown by a slice is
+// rethrown after all threads are joined. If a thread can't be started, the
+// threads already running are joined before the error is rethrown
+template <typename Visit>
+void run_rank_chunks(size_t first, size_t last, size_t chunks, Visit visit) {
+  const auto count = last - first;
+  chunks = std::max(size_t{1}, std::min(chunks, count));
+  auto errors = std::vector<std::exception_ptr>(chunks);
+  auto guarded = [&visit, &errors, first, count, chunks](size_t chunk) {
+    try {
+      visit(chunk, first + count * chunk / chunks, first + count * (chunk + 1) / chunks);
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+  auto workers = std::vector<std::thread>{};
+  workers.reserve(chunks - 1);
+  try {
+    for (auto chunk = size_t{1}; chunk < chunks; ++chunk) {
+      workers.emplace_back(guarded, chunk);
+    }
+  } catch (...) {
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    throw;
+  }
+  guarded(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const auto& error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+// partial result of one slice, wrapped so std::vector<bool> isn't used
+template <typename T>
+struct reduce_slot {
+  T value;
+};
+
+// call `visitor` for `count` nodes in key order starting at the node of rank
+// `first`, the tree is not rebalanced
+template <typename Value, typename Visitor>
+void walk_ranks(const tree_node<Value>* root, size_t first, size_t count, Visitor& visitor) {
+  if (count == 0) {
+    return;
+  }
+  auto node = order_statistic_subtree(root, first);
+  for (auto idx = size_t{0}; idx < count; ++idx) {
+    assert(node != nullptr);
+    visitor(node->value);
+    node = node->next_node();
+  }
+}
+
+}  // namespace detail
+
+// Call `function` for every value of `tree` with keys in [low, high] on
+// `threads` threads. The range is cut into slices of equal rank with order
+// statistic descents on the `size` field, every slice is walked in key order
+// without splaying. `function` must be safe to call concurrently and the tree
+// must not be modified until the call returns
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor, typename Function>
+void parallel_for_each(
+    const splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree,
+    const Key& low,
+    const Key& high,
+    Function function,
+    size_t threads = std::thread::hardware_concurrency()) {
+  const auto first = tree.rank(low);
+  const auto last = detail::count_not_greater_subtree(
+    tree.root(), high, tree.key_comparator(), tree.key_extractor());
+  if (last <= first) {
+    return;
+  }
+  detail::run_rank_chunks(first, last, threads, [&tree, &function](size_t, size_t begin, size_t end) {
+    detail::walk_ranks(tree.root(), begin, end - begin, function);
+  });
+}
+
+// Reduce the values of `tree` with keys in [low, high] on `threads` threads.
+// Every slice starts from `init` and folds its values in key order with
+// `fold(accumulator, value)`, partial results are joined in key order with
+// `combine(lhs, rhs)`. `init` must be an identity of `combine`, so the result
+// doesn't depend on the number of threads
+template <
+  typename Key, typename Value, typename KeyComparator, typename KeyExtractor,
+  typename T, typename Fold, typename Combine>
+T parallel_reduce(
+    const splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree,
+    const Key& low,
+    const Key& high,
+    T init,
+    Fold fold,
+    Combine combine,
+    size_t threads = std::thread::hardware_concurrency()) {
+  const auto first = tree.rank(low);
+  const auto last = detail::count_not_greater_subtree(
+    tree.root(), high, tree.key_comparator(), tree.key_extractor());
+  if (last <= first) {
+    return init;
+  }
+  const auto chunks = std::max(size_t{1}, std::min(threads, last - first));
+  auto partial = std::vector<detail::reduce_slot<T>>(chunks, detail::reduce_slot<T>{init});
+  detail::run_rank_chunks(first, last, chunks, [&tree, &fold, &partial](size_t chunk, size_t begin, size_t end) {
+    auto& accumulator = partial[chunk].value;
+    auto visitor = [&accumulator, &fold](const Value& value) {
+      accumulator = fold(std::move(accumulator), value);
+    };
+    detail::walk_ranks(tree.root(), begin, end - begin, visitor);
+  });
+  auto result = std::move(partial.front().value);
+  for (auto chunk = size_t{1}; chunk < chunks; ++chunk) {
+    result = combine(std::move(result), std::move(partial[chunk].value));
+  }
+  return result;
+}
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_PARALLEL_TRAVERSAL_H_
@@ -0,0 +1,194 @@
+#ifndef SPLAY_TREE_RANKING_INDEX_H_
+#define SPLAY_TREE_RANKING_INDEX_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+template <typename Id, typename Score>
+struct ranked_entry {
+  Id id;
+  Score score;
+};
+
+template <typename Id, typename Score>
+std::ostream& operator << (std::ostream& out, const ranked_entry<Id, Score>& entry) {
+  out << entry.id << ":" << entry.score;
+  return out;
+}
+
+// Leaderboard of ids ordered by score, highest score first and ties broken by
+// id. Entries live in an order statistic splay tree keyed by (score, id) and a
+// hash map finds the node of an id, so updates, rank lookups and score range
+// counts cost O(log n) amortized and pages of `k` entries O(log n + k)
+template <
+  typename Id,
+  typename Score,
+  typename IdHash = std::hash<Id>,
+  typename IdComparator = std::less<Id>,
+  typename ScoreComparator = std::less<Score>>
+class ranking_index {
+  using entry_type = ranked_entry<Id, Score>;
+
+  // `bound` places the key before (-1) or after (+1) all ids with its score,
+  // bound keys have no id
+  struct rank_key {
+    Score score;
+    const Id* id;
+    int32_t bound;
+  };
+
+  struct rank_key_extractor {
+    rank_key operator () (const entry_type& entry) const {
+      return rank_key{entry.score, &entry.id, 0};
+    }
+  };
+
+  struct rank_key_comparator {
+    bool operator () (const rank_key& lhs, const rank_key& rhs) const {
+      if (score_comparator(rhs.score, lhs.score)) {
+        return true;
+      }
+      if (score_comparator(lhs.score, rhs.score)) {
+        return false;
+      }
+      if (lhs.bound != 0 || rhs.bound != 0) {
+        return lhs.bound < rhs.bound;
+      }
+      return id_comparator(*lhs.id, *rhs.id);
+    }
+
+    IdComparator id_comparator;
+    ScoreComparator score_comparator;
+  };
+
+ public:
+  using tree_type = splay_tree<rank_key, entry_type, rank_key_comparator, rank_key_extractor>;
+  using node_type = tree_node<entry_type>;
+
+  ranking_index()
+    : tree{}
+    , nodes{}
+  {}
+
+  // nodes are shared between the tree and the map, so the index can't be copied
+  ranking_index(const ranking_index& other) = delete;
+  ranking_index(ranking_index&& other) = default;
+  ranking_index& operator = (const ranking_index& other) = delete;
+  ranking_index& operator = (ranking_index&& other) = default;
+
+  size_t size() const noexcept {
+    return tree.size();
+  }
+
+  bool empty() const noexcept {
+    return tree.empty();
+  }
+
+  void clear() noexcept {
+    tree.clear();
+    nodes.clear();
+  }
+
+  bool contains(const Id& id) const {
+    return nodes.find(id) != nodes.end();
+  }
+
+  // set the score of `id`, inserting it if it is not ranked yet
+  void update_score(const Id& id, const Score& score) {
+    auto it = nodes.find(id);
+    if (it != nodes.end()) {
+      // relink the node at its new score instead of reallocating it
+      auto node = tree.detach(it->second);
+      node->value.score = score;
+      tree.insert_node(node);
+    } else {
+      nodes.emplace(id, tree.insert(entry_type{id, score}));
+    }
+  }
+
+  bool erase(const Id& id) {
+    auto it = nodes.find(id);
+    if (it == nodes.end()) {
+      return false;
+    }
+    tree.erase(it->second);
+    nodes.erase(it);
+    return true;
+  }
+
+  // score of `id`, null if it is not ranked
+  const Score* score_of(const Id& id) const {
+    auto it = nodes.find(id);
+    return it != nodes.end() ? &it->second->value.score : nullptr;
+  }
+
+  // 0-based position of `id` in the ranking, `size()` if it is not ranked
+  size_t rank_of(const Id& id) {
+    auto it = nodes.find(id);
+    if (it == nodes.end()) {
+      return this->size();
+    }
+    auto node = it->second;
+    tree.splay(node);
+    return node->left != nullptr ? node->left->size : size_t{0};
+  }
+
+  // entry at position `rank`, null if there is none
+  const entry_type* at(size_t rank) noexcept {
+    auto node = tree.order_statistic(rank);
+    return node != nullptr ? &node->value : nullptr;
+  }
+
+  // at most `count` entries starting at position `offset`
+  std::vector<entry_type> page(size_t offset, size_t count) {
+    auto entries = std::vector<entry_type>{};
+    const node_type* node = tree.order_statistic(offset);
+    while (node != nullptr && entries.size() < count) {
+      entries.push_back(node->value);
+      node = node->next_node();
+    }
+    return entries;
+  }
+
+  std::vector<entry_type> top_k(size_t k) {
+    return this->page(0, k);
+  }
+
+  // number of ids with scores in [low, high]
+  size_t count_scores(const Score& low, const Score& high) {
+    // ranks of the first entry with score not above `high` and the first
+    // entry with score below `low`
+    const auto first = this->rank_of_bound(rank_key{high, nullptr, -1});
+    const auto last = this->rank_of_bound(rank_key{low, nullptr, 1});
+    return first < last ? last - first : size_t{0};
+  }
+
+  const tree_type& get_tree() const noexcept {
+    return tree;
+  }
+
+ private:
+  size_t rank_of_bound(const rank_key& key) {
+    auto node = tree.lower_bound(key);
+    if (node == nullptr) {
+      return this->size();
+    }
+    return node->left != nullptr ? node->left->size : size_t{0};
+  }
+
+  tree_type tree;
+  std::unordered_map<Id, node_type*, IdHash> nodes;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_RANKING_INDEX_H_
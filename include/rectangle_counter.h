@@ -0,0 +1,230 @@
+#ifndef SPLAY_TREE_RECTANGLE_COUNTER_H_
+#define SPLAY_TREE_RECTANGLE_COUNTER_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "parallel_traversal.h"
+#include "splay_tree.h"
+
+namespace splay {
+
+template <typename Coord>
+struct plane_point {
+  Coord x;
+  Coord y;
+};
+
+// closed rectangle [x_low, x_high] x [y_low, y_high]
+template <typename Coord>
+struct plane_rectangle {
+  Coord x_low;
+  Coord x_high;
+  Coord y_low;
+  Coord y_high;
+};
+
+namespace detail {
+
+// Multiset of y coordinates answering "how many in [low, high]" with two rank
+// queries on an order statistic splay tree. Equal coordinates are told apart
+// by the index of their point
+template <typename Coord>
+class y_rank_counter {
+  using key_type = std::pair<Coord, size_t>;
+
+  struct key_extractor {
+    const key_type& operator () (const key_type& key) const noexcept {
+      return key;
+    }
+  };
+
+  using tree_type = splay_tree<key_type, key_type, std::less<key_type>, key_extractor>;
+
+ public:
+  y_rank_counter()
+    : tree{}
+  {}
+
+  void insert(const Coord& y, size_t id) {
+    tree.insert(key_type{y, id});
+  }
+
+  size_t count(const Coord& low, const Coord& high) {
+    if (high < low) {
+      return 0;
+    }
+    const auto last = this->rank_of_bound(
+      tree.upper_bound(key_type{high, std::numeric_limits<size_t>::max()}));
+    const auto first = this->rank_of_bound(tree.lower_bound(key_type{low, size_t{0}}));
+    return last - first;
+  }
+
+ private:
+  // bounds are splayed to the root, so their rank is the size of the left subtree
+  size_t rank_of_bound(const tree_node<key_type>* node) const noexcept {
+    if (node == nullptr) {
+      return tree.size();
+    }
+    return node->left != nullptr ? node->left->size : size_t{0};
+  }
+
+  tree_type tree;
+};
+
+// query endpoint of the sweep, `closing` endpoints count points with x not
+// above `x`, opening endpoints count points with x below `x`
+template <typename Coord>
+struct sweep_event {
+  Coord x;
+  bool closing;
+  size_t query;
+};
+
+template <typename Coord>
+std::vector<sweep_event<Coord>> make_sweep_events(
+    const std::vector<plane_rectangle<Coord>>& rectangles) {
+  auto events = std::vector<sweep_event<Coord>>{};
+  events.reserve(2 * rectangles.size());
+  for (auto idx = size_t{0}; idx < rectangles.size(); ++idx) {
+    const auto& rectangle = rectangles[idx];
+    if (rectangle.x_high < rectangle.x_low || rectangle.y_high < rectangle.y_low) {
+      continue;
+    }
+    events.push_back(sweep_event<Coord>{rectangle.x_low, false, idx});
+    events.push_back(sweep_event<Coord>{rectangle.x_high, true, idx});
+  }
+  // at equal x opening endpoints go first, before points at that x are added
+  std::sort(std::begin(events), std::end(events),
+    [](const sweep_event<Coord>& lhs, const sweep_event<Coord>& rhs) {
+      if (lhs.x < rhs.x) {
+        return true;
+      }
+      if (rhs.x < lhs.x) {
+        return false;
+      }
+      return !lhs.closing && rhs.closing;
+    });
+  return events;
+}
+
+// indices of `points` ordered by x
+template <typename Coord>
+std::vector<size_t> order_by_x(const std::vector<plane_point<Coord>>& points) {
+  auto order = std::vector<size_t>(points.size());
+  for (auto idx = size_t{0}; idx < order.size(); ++idx) {
+    order[idx] = idx;
+  }
+  std::sort(std::begin(order), std::end(order), [&points](size_t lhs, size_t rhs) {
+    return points[lhs].x < points[rhs].x;
+  });
+  return order;
+}
+
+// Sweep the points `order[first, last)` (sorted by x) against all endpoints
+// and store the counts of points in every rectangle into `counts`. Points
+// passed between two endpoints are inserted as one batch sorted by y, so
+// consecutive insertions land next to the previously splayed node
+template <typename Coord>
+void sweep_rectangles(
+    const std::vector<plane_point<Coord>>& points,
+    const std::vector<size_t>& order,
+    size_t first,
+    size_t last,
+    const std::vector<plane_rectangle<Coord>>& rectangles,
+    const std::vector<sweep_event<Coord>>& events,
+    std::vector<size_t>& counts) {
+  auto counter = y_rank_counter<Coord>{};
+  auto batch = std::vector<size_t>{};
+  auto next = first;
+  for (const auto& event : events) {
+    batch.clear();
+    while (next < last && (event.closing
+        ? !(event.x < points[order[next]].x)
+        : points[order[next]].x < event.x)) {
+      batch.push_back(order[next++]);
+    }
+    std::sort(std::begin(batch), std::end(batch), [&points](size_t lhs, size_t rhs) {
+      return points[lhs].y < points[rhs].y;
+    });
+    for (const auto& idx : batch) {
+      counter.insert(points[idx].y, idx);
+    }
+    const auto& rectangle = rectangles[event.query];
+    const auto count = counter.count(rectangle.y_low, rectangle.y_high);
+    // the opening endpoint of a rectangle is always swept before its closing one
+    counts[event.query] = event.closing ? count - counts[event.query] : count;
+  }
+}
+
+}  // namespace detail
+
+// Number of `points` inside every rectangle of `rectangles`, computed offline
+// in O((n + q) log n) amortized. The plane is swept along x and y ranks of the
+// swept points are kept in a splay tree, a rectangle count is the difference
+// of two rank queries at its closing and opening x
+template <typename Coord>
+std::vector<size_t> count_rectangles(
+    const std::vector<plane_point<Coord>>& points,
+    const std::vector<plane_rectangle<Coord>>& rectangles) {
+  auto counts = std::vector<size_t>(rectangles.size(), size_t{0});
+  const auto order = detail::order_by_x(points);
+  const auto events = detail::make_sweep_events(rectangles);
+  detail::sweep_rectangles(points, order, 0, order.size(), rectangles, events, counts);
+  return counts;
+}
+
+// Same counts as `count_rectangles` with the points cut into `slabs` vertical
+// slabs of equal size swept by separate threads. Every slab answers all
+// rectangles for its own points and the partial counts are summed, so the
+// work grows to O(n log n + slabs * q log n) while the running time drops to
+// O((n / slabs + q) log n)
+template <typename Coord>
+std::vector<size_t> count_rectangles_parallel(
+    const std::vector<plane_point<Coord>>& points,
+    const std::vector<plane_rectangle<Coord>>& rectangles,
+    size_t slabs = std::thread::hardware_concurrency()) {
+  slabs = std::max(size_t{1}, std::min(slabs, points.size()));
+  const auto order = detail::order_by_x(points);
+  const auto events = detail::make_sweep_events(rectangles);
+  auto partial = std::vector<std::vector<size_t>>(
+    slabs, std::vector<size_t>(rectangles.size(), size_t{0}));
+  // slabs are ranges of ranks in x order
+  detail::run_rank_chunks(size_t{0}, order.size(), slabs,
+    [&points, &order, &rectangles, &events, &partial](size_t slab, size_t first, size_t last) {
+      detail::sweep_rectangles(points, order, first, last, rectangles, events, partial[slab]);
+    });
+  auto counts = std::move(partial.front());
+  for (auto slab = size_t{1}; slab < slabs; ++slab) {
+    for (auto idx = size_t{0}; idx < counts.size(); ++idx) {
+      counts[idx] += partial[slab][idx];
+    }
+  }
+  return counts;
+}
+
+// number of `points` dominated by every corner of `corners`, i.e. with both
+// coordinates not above the coordinates of the corner
+template <typename Coord>
+std::vector<size_t> count_dominated(
+    const std::vector<plane_point<Coord>>& points,
+    const std::vector<plane_point<Coord>>& corners) {
+  auto rectangles = std::vector<plane_rectangle<Coord>>{};
+  rectangles.reserve(corners.size());
+  const auto lowest = std::numeric_limits<Coord>::lowest();
+  for (const auto& corner : corners) {
+    rectangles.push_back(plane_rectangle<Coord>{lowest, corner.x, lowest, corner.y});
+  }
+  return count_rectangles(points, rectangles);
+}
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_RECTANGLE_COUNTER_H_
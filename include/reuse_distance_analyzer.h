@@ -0,0 +1,138 @@
+#ifndef SPLAY_TREE_REUSE_DISTANCE_ANALYZER_H_
+#define SPLAY_TREE_REUSE_DISTANCE_ANALYZER_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+// LRU stack distance of every access of a trace: the number of distinct
+// addresses touched since the previous access of the same address. Every
+// distinct address keeps its last access time in an order statistic splay
+// tree, the distance is the number of times greater than the previous access
+// time of the address. A trace of `n` accesses is processed in O(n log n)
+// amortized. Distances up to `max_distance` are counted exactly, larger ones
+// go to one overflow bucket
+template <typename Address, typename Hash = std::hash<Address>>
+class reuse_distance_analyzer {
+  struct time_extractor {
+    uint64_t operator () (uint64_t time) const noexcept {
+      return time;
+    }
+  };
+
+  using tree_type = splay_tree<uint64_t, uint64_t, std::less<uint64_t>, time_extractor>;
+
+ public:
+  // distance of the first access to an address
+  static constexpr uint64_t kColdMiss = std::numeric_limits<uint64_t>::max();
+
+  explicit reuse_distance_analyzer(size_t max_distance = size_t{1} << 20)
+    : times{}
+    , last_access{}
+    , histogram(max_distance + 1, uint64_t{0})
+    , overflow{0}
+    , cold_misses{0}
+    , clock{0}
+  {}
+
+  // record an access to `address` and return its reuse distance
+  uint64_t access(const Address& address) {
+    const auto now = clock++;
+    auto distance = kColdMiss;
+    auto it = last_access.find(address);
+    if (it == last_access.end()) {
+      last_access.emplace(address, now);
+      ++cold_misses;
+    } else {
+      auto node = times.find(it->second);
+      assert(node != nullptr);
+      distance = node->right != nullptr ? node->right->size : uint64_t{0};
+      times.erase(node);
+      it->second = now;
+      if (distance < histogram.size()) {
+        ++histogram[distance];
+      } else {
+        ++overflow;
+      }
+    }
+    times.insert(now);
+    return distance;
+  }
+
+  template <typename Iter>
+  void access(Iter first, Iter last) {
+    for (auto it = first; it != last; ++it) {
+      this->access(*it);
+    }
+  }
+
+  uint64_t accesses() const noexcept {
+    return clock;
+  }
+
+  uint64_t distinct_addresses() const noexcept {
+    return cold_misses;
+  }
+
+  // number of accesses with reuse distance `distance` for every distance up to
+  // `max_distance`
+  const std::vector<uint64_t>& distance_histogram() const noexcept {
+    return histogram;
+  }
+
+  // number of reuses with distance above `max_distance`
+  uint64_t overflow_count() const noexcept {
+    return overflow;
+  }
+
+  // miss ratio of a fully associative LRU cache of `cache_size` entries
+  // an access misses if it's cold or its reuse distance is at least `cache_size`
+  // exact for cache sizes up to `max_distance + 1`
+  double miss_ratio(size_t cache_size) const noexcept {
+    if (clock == 0) {
+      return 0.0;
+    }
+    auto hits = uint64_t{0};
+    const auto limit = cache_size < histogram.size() ? cache_size : histogram.size();
+    for (auto distance = size_t{0}; distance < limit; ++distance) {
+      hits += histogram[distance];
+    }
+    return static_cast<double>(clock - hits) / static_cast<double>(clock);
+  }
+
+  // miss ratios for all cache sizes from 0 to `max_distance + 1`, computed in
+  // one pass over the histogram
+  std::vector<double> miss_ratio_curve() const {
+    auto curve = std::vector<double>{};
+    curve.reserve(histogram.size() + 1);
+    auto misses = clock;
+    curve.push_back(clock != 0 ? 1.0 : 0.0);
+    for (const auto& count : histogram) {
+      misses -= count;
+      curve.push_back(clock != 0 ? static_cast<double>(misses) / static_cast<double>(clock) : 0.0);
+    }
+    return curve;
+  }
+
+ private:
+  tree_type times;
+  std::unordered_map<Address, uint64_t, Hash> last_access;
+  std::vector<uint64_t> histogram;
+  uint64_t overflow;
+  uint64_t cold_misses;
+  uint64_t clock;
+};
+
+template <typename Address, typename Hash>
+constexpr uint64_t reuse_distance_analyzer<Address, Hash>::kColdMiss;
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_REUSE_DISTANCE_ANALYZER_H_
@@ -0,0 +1,451 @@
+#ifndef SPLAY_TREE_ROARING_SET_H_
+#define SPLAY_TREE_ROARING_SET_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+
+namespace detail {
+
+// Set of 16-bit values kept as a sorted array while sparse, as a bitmap of
+// 2^16 bits while dense and, after `run_optimize`, as sorted runs of
+// consecutive values when those are smaller. Rank queries on bitmaps are
+// popcounts of whole words
+class roaring_container {
+ public:
+  enum class container_kind : uint32_t {
+    kArray,
+    kBitmap,
+    kRun
+  };
+
+  // the largest array, beyond it a bitmap is smaller
+  static constexpr uint32_t kArrayLimit = 4096;
+  static constexpr uint32_t kBitmapWords = 1024;
+
+  roaring_container()
+    : kind{container_kind::kArray}
+    , array{}
+    , bitmap{}
+    , runs{}
+    , run_prefix{}
+    , count{0}
+  {}
+
+  container_kind get_kind() const noexcept {
+    return kind;
+  }
+
+  uint32_t cardinality() const noexcept {
+    return count;
+  }
+
+  bool empty() const noexcept {
+    return count == 0;
+  }
+
+  bool contains(uint16_t low) const noexcept {
+    switch (kind) {
+      case container_kind::kArray:
+        return std::binary_search(std::begin(array), std::end(array), low);
+      case container_kind::kBitmap:
+        return (bitmap[low >> 6] >> (low & 63)) & uint64_t{1};
+      case container_kind::kRun: {
+        const auto idx = this->run_index(low);
+        return idx < runs.size() && runs[idx].first <= low && low <= runs[idx].second;
+      }
+    }
+    return false;
+  }
+
+  // number of values less than `low`
+  uint32_t rank(uint16_t low) const noexcept {
+    switch (kind) {
+      case container_kind::kArray:
+        return static_cast<uint32_t>(std::lower_bound(std::begin(array), std::end(array), low) - std::begin(array));
+      case container_kind::kBitmap: {
+        auto result = uint32_t{0};
+        const auto word = static_cast<uint32_t>(low >> 6);
+        for (auto idx = uint32_t{0}; idx < word; ++idx) {
+          result += static_cast<uint32_t>(__builtin_popcountll(bitmap[idx]));
+        }
+        const auto mask = (uint64_t{1} << (low & 63)) - 1;
+        return result + static_cast<uint32_t>(__builtin_popcountll(bitmap[word] & mask));
+      }
+      case container_kind::kRun: {
+        const auto idx = this->run_index(low);
+        if (low <= runs[idx].first) {
+          return run_prefix[idx];
+        }
+        if (low > runs[idx].second) {
+          return run_prefix[idx + 1];
+        }
+        return run_prefix[idx] + (low - runs[idx].first);
+      }
+    }
+    return 0;
+  }
+
+  // insert `low`, returns false if it was present
+  bool add(uint16_t low) {
+    if (kind == container_kind::kRun) {
+      this->unpack_runs();
+    }
+    if (kind == container_kind::kBitmap) {
+      auto& word = bitmap[low >> 6];
+      const auto bit = uint64_t{1} << (low & 63);
+      if ((word & bit) != 0) {
+        return false;
+      }
+      word |= bit;
+      ++count;
+      return true;
+    }
+    auto it = std::lower_bound(std::begin(array), std::end(array), low);
+    if (it != std::end(array) && *it == low) {
+      return false;
+    }
+    array.insert(it, low);
+    ++count;
+    if (count > kArrayLimit) {
+      this->array_to_bitmap();
+    }
+    return true;
+  }
+
+  // erase `low`, returns false if it was missing
+  bool remove(uint16_t low) {
+    if (kind == container_kind::kRun) {
+      this->unpack_runs();
+    }
+    if (kind == container_kind::kBitmap) {
+      auto& word = bitmap[low >> 6];
+      const auto bit = uint64_t{1} << (low & 63);
+      if ((word & bit) == 0) {
+        return false;
+      }
+      word &= ~bit;
+      --count;
+      if (count <= kArrayLimit / 2) {
+        this->bitmap_to_array();
+      }
+      return true;
+    }
+    auto it = std::lower_bound(std::begin(array), std::end(array), low);
+    if (it == std::end(array) || *it != low) {
+      return false;
+    }
+    array.erase(it);
+    --count;
+    return true;
+  }
+
+  // switch to runs if they take less memory than the current representation
+  void run_optimize() {
+    if (kind == container_kind::kRun || count == 0) {
+      return;
+    }
+    auto packed = std::vector<std::pair<uint16_t, uint16_t>>{};
+    this->for_each([&packed](uint16_t low) {
+      if (!packed.empty() && packed.back().second + 1 == low) {
+        packed.back().second = low;
+      } else {
+        packed.emplace_back(low, low);
+      }
+    });
+    if (packed.size() * sizeof(packed.front()) >= this->payload_bytes()) {
+      return;
+    }
+    runs = std::move(packed);
+    runs.shrink_to_fit();
+    run_prefix.assign(runs.size() + 1, uint32_t{0});
+    for (auto idx = size_t{0}; idx < runs.size(); ++idx) {
+      run_prefix[idx + 1] = run_prefix[idx] + (runs[idx].second - runs[idx].first) + 1;
+    }
+    std::vector<uint16_t>{}.swap(array);
+    std::vector<uint64_t>{}.swap(bitmap);
+    kind = container_kind::kRun;
+  }
+
+  // bytes of the values, not counting the container itself
+  size_t payload_bytes() const noexcept {
+    return array.capacity() * sizeof(uint16_t) + bitmap.capacity() * sizeof(uint64_t) +
+      runs.capacity() * sizeof(std::pair<uint16_t, uint16_t>) + run_prefix.capacity() * sizeof(uint32_t);
+  }
+
+  // call `visitor` for every value in increasing order
+  template <typename Visitor>
+  void for_each(Visitor visitor) const {
+    switch (kind) {
+      case container_kind::kArray:
+        for (const auto& low : array) {
+          visitor(low);
+        }
+        break;
+      case container_kind::kBitmap:
+        for (auto idx = uint32_t{0}; idx < kBitmapWords; ++idx) {
+          for (auto word = bitmap[idx]; word != 0; word &= word - 1) {
+            visitor(static_cast<uint16_t>(idx * 64 + static_cast<uint32_t>(__builtin_ctzll(word))));
+          }
+        }
+        break;
+      case container_kind::kRun:
+        for (const auto& run : runs) {
+          for (auto low = uint32_t{run.first}; low <= run.second; ++low) {
+            visitor(static_cast<uint16_t>(low));
+          }
+        }
+        break;
+    }
+  }
+
+ private:
+  // index of the last run starting not after `low`, or of the first run if
+  // all runs start after it
+  size_t run_index(uint16_t low) const noexcept {
+    auto it = std::upper_bound(std::begin(runs), std::end(runs), low,
+      [](uint16_t value, const std::pair<uint16_t, uint16_t>& run) {
+        return value < run.first;
+      });
+    return it == std::begin(runs) ? size_t{0} : static_cast<size_t>(it - std::begin(runs)) - 1;
+  }
+
+  void array_to_bitmap() {
+    bitmap.assign(kBitmapWords, uint64_t{0});
+    for (const auto& low : array) {
+      bitmap[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    std::vector<uint16_t>{}.swap(array);
+    kind = container_kind::kBitmap;
+  }
+
+  void bitmap_to_array() {
+    array.clear();
+    array.reserve(count);
+    this->for_each([this](uint16_t low) {
+      array.push_back(low);
+    });
+    std::vector<uint64_t>{}.swap(bitmap);
+    kind = container_kind::kArray;
+  }
+
+  void unpack_runs() {
+    auto values = std::vector<uint16_t>{};
+    values.reserve(count);
+    this->for_each([&values](uint16_t low) {
+      values.push_back(low);
+    });
+    std::vector<std::pair<uint16_t, uint16_t>>{}.swap(runs);
+    std::vector<uint32_t>{}.swap(run_prefix);
+    array = std::move(values);
+    kind = container_kind::kArray;
+    if (count > kArrayLimit) {
+      this->array_to_bitmap();
+    }
+  }
+
+  container_kind kind;
+  std::vector<uint16_t> array;
+  std::vector<uint64_t> bitmap;
+  std::vector<std::pair<uint16_t, uint16_t>> runs;
+  std::vector<uint32_t> run_prefix;
+  uint32_t count;
+};
+
+}  // namespace detail
+
+// values of one 2^16 wide key chunk, `total` counts the values of the subtree
+struct roaring_chunk {
+  uint64_t high;
+  detail::roaring_container values;
+  uint64_t total;
+};
+
+inline std::ostream& operator << (std::ostream& out, const roaring_chunk& chunk) {
+  out << chunk.high << ":" << chunk.values.cardinality();
+  return out;
+}
+
+template <>
+struct node_augmentation<roaring_chunk> {
+  static void update(tree_node<roaring_chunk>* node) noexcept {
+    auto total = uint64_t{node->value.values.cardinality()};
+    if (node->left != nullptr) {
+      total += node->left->value.total;
+    }
+    if (node->right != nullptr) {
+      total += node->right->value.total;
+    }
+    node->value.total = total;
+  }
+};
+
+namespace detail {
+
+struct roaring_chunk_key_extractor {
+  uint64_t operator () (const roaring_chunk& chunk) const noexcept {
+    return chunk.high;
+  }
+};
+
+}  // namespace detail
+
+// Set of 64-bit integers for dense clusters of values. Keys are cut into
+// 2^16 wide chunks, every chunk is one splay tree node holding a sorted
+// array, a bitmap or runs depending on its density, so dense sets take a
+// few bits per value instead of a node per value. Nodes count the values of
+// their subtree, so `rank` and `count` cost one splay plus one rank query
+// inside a container
+class roaring_set {
+ public:
+  using tree_type = splay_tree<uint64_t, roaring_chunk, std::less<uint64_t>, detail::roaring_chunk_key_extractor>;
+
+  roaring_set()
+    : tree{}
+  {}
+
+  size_t size() const noexcept {
+    return tree.empty() ? size_t{0} : static_cast<size_t>(tree.root()->value.total);
+  }
+
+  bool empty() const noexcept {
+    return this->size() == 0;
+  }
+
+  // number of 2^16 wide chunks holding values
+  size_t chunk_count() const noexcept {
+    return tree.size();
+  }
+
+  void clear() noexcept {
+    tree.clear();
+  }
+
+  // insert `value`, returns false if it was present
+  bool insert(int64_t value) {
+    const auto key = to_unsigned(value);
+    auto node = tree.find(high_bits(key));
+    if (node == nullptr) {
+      node = tree.insert(roaring_chunk{high_bits(key), detail::roaring_container{}, 0});
+    }
+    const auto inserted = node->value.values.add(low_bits(key));
+    node_augmentation<roaring_chunk>::update(node);
+    return inserted;
+  }
+
+  // erase `value`, returns false if it was missing
+  bool erase(int64_t value) {
+    const auto key = to_unsigned(value);
+    auto node = tree.find(high_bits(key));
+    if (node == nullptr || !node->value.values.remove(low_bits(key))) {
+      return false;
+    }
+    if (node->value.values.empty()) {
+      tree.erase(node);
+    } else {
+      node_augmentation<roaring_chunk>::update(node);
+    }
+    return true;
+  }
+
+  bool contains(int64_t value) {
+    const auto key = to_unsigned(value);
+    auto node = tree.find(high_bits(key));
+    return node != nullptr && node->value.values.contains(low_bits(key));
+  }
+
+  // number of values less than `value`
+  size_t rank(int64_t value) {
+    const auto key = to_unsigned(value);
+    auto node = tree.lower_bound(high_bits(key));
+    if (node == nullptr) {
+      return this->size();
+    }
+    // the bound is the root now, all chunks before it are in the left subtree
+    auto result = node->left != nullptr ? node->left->value.total : uint64_t{0};
+    if (node->value.high == high_bits(key)) {
+      result += node->value.values.rank(low_bits(key));
+    }
+    return static_cast<size_t>(result);
+  }
+
+  // number of values in [low, high]
+  size_t count(int64_t low, int64_t high) {
+    assert(low <= high);
+    const auto below_high = this->rank(high) + (this->contains(high) ? 1 : 0);
+    return below_high - this->rank(low);
+  }
+
+  // convert chunks to runs of consecutive values where that saves memory,
+  // changed chunks go back to arrays or bitmaps when they are modified
+  void run_optimize() {
+    if (tree.empty()) {
+      return;
+    }
+    for (auto node = tree.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      node->value.values.run_optimize();
+    }
+  }
+
+  // approximate heap memory of the set in bytes
+  size_t memory_usage() const noexcept {
+    auto bytes = size_t{0};
+    if (tree.empty()) {
+      return bytes;
+    }
+    for (auto node = tree.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      bytes += sizeof(*node) + node->value.values.payload_bytes();
+    }
+    return bytes;
+  }
+
+  // call `visitor` for every value in increasing order
+  template <typename Visitor>
+  void for_each(Visitor visitor) const {
+    if (tree.empty()) {
+      return;
+    }
+    for (auto node = tree.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      const auto base = node->value.high << 16;
+      node->value.values.for_each([&visitor, base](uint16_t low) {
+        visitor(to_signed(base | low));
+      });
+    }
+  }
+
+  const tree_type& get_tree() const noexcept {
+    return tree;
+  }
+
+ private:
+  // flip the sign bit so unsigned order matches signed order
+  static uint64_t to_unsigned(int64_t value) noexcept {
+    return static_cast<uint64_t>(value) ^ (uint64_t{1} << 63);
+  }
+
+  static int64_t to_signed(uint64_t key) noexcept {
+    return static_cast<int64_t>(key ^ (uint64_t{1} << 63));
+  }
+
+  static uint64_t high_bits(uint64_t key) noexcept {
+    return key >> 16;
+  }
+
+  static uint16_t low_bits(uint64_t key) noexcept {
+    return static_cast<uint16_t>(key & 0xFFFF);
+  }
+
+  tree_type tree;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_ROARING_SET_H_
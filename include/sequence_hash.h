@@ -0,0 +1,162 @@
+#ifndef SPLAY_TREE_SEQUENCE_HASH_H_
+#define SPLAY_TREE_SEQUENCE_HASH_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+
+#include "implicit_splay_tree.h"
+
+namespace splay {
+namespace detail {
+
+// polynomial hashing is done modulo the Mersenne prime 2^61 - 1
+constexpr uint64_t kHashModulus = (uint64_t{1} << 61) - 1;
+constexpr uint64_t kHashBase = uint64_t{1000003};
+
+inline uint64_t hash_add(uint64_t lhs, uint64_t rhs) noexcept {
+  const auto sum = lhs + rhs;
+  return sum >= kHashModulus ? sum - kHashModulus : sum;
+}
+
+inline uint64_t hash_multiply(uint64_t lhs, uint64_t rhs) noexcept {
+  const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+  const auto low = static_cast<uint64_t>(product) & kHashModulus;
+  const auto high = static_cast<uint64_t>(product >> 61);
+  return hash_add(low, high);
+}
+
+// map an arbitrary 64 bit hash onto [1, kHashModulus) so that no element hashes to zero
+inline uint64_t hash_element(uint64_t hash) noexcept {
+  hash ^= hash >> 33;
+  hash *= uint64_t{0xff51afd7ed558ccd};
+  hash ^= hash >> 33;
+  return hash % (kHashModulus - 1) + 1;
+}
+
+}  // namespace detail
+
+// Element of a hashed sequence. Besides the element itself every node stores
+// the polynomial hash of its subtree sequence, the hash of the same sequence
+// read backwards and base^(subtree size)
+template <typename T, typename Hasher = std::hash<T>>
+struct hashed_value {
+  hashed_value(const T& element)
+    : element{element}
+    , element_hash{detail::hash_element(Hasher{}(element))}
+    , hash{element_hash}
+    , reversed_hash{element_hash}
+    , power{detail::kHashBase}
+  {}
+
+  T element;
+  uint64_t element_hash;
+  uint64_t hash;
+  uint64_t reversed_hash;
+  uint64_t power;
+};
+
+template <typename T, typename Hasher>
+std::ostream& operator << (std::ostream& out, const hashed_value<T, Hasher>& value) {
+  out << value.element;
+  return out;
+}
+
+template <typename T, typename Hasher>
+struct node_augmentation<hashed_value<T, Hasher>> {
+  static void update(tree_node<hashed_value<T, Hasher>>* node) noexcept {
+    /* sequence of the subtree is L + [x] + R
+    *
+    *   hash(S)          = hash(L) * B^(|R| + 1) + h(x) * B^|R| + hash(R)
+    *   reversed_hash(S) = reversed_hash(R) * B^(|L| + 1) + h(x) * B^|L| + reversed_hash(L)
+    */
+    auto& value = node->value;
+    const auto* const left = node->left;
+    const auto* const right = node->right;
+    const auto left_power = left != nullptr ? left->value.power : uint64_t{1};
+    const auto right_power = right != nullptr ? right->value.power : uint64_t{1};
+    auto hash = value.element_hash;
+    auto reversed_hash = value.element_hash;
+    if (left != nullptr) {
+      hash = detail::hash_add(
+        detail::hash_multiply(left->value.hash, detail::kHashBase), hash);
+      reversed_hash = detail::hash_add(
+        detail::hash_multiply(reversed_hash, left_power), left->value.reversed_hash);
+    }
+    if (right != nullptr) {
+      hash = detail::hash_add(detail::hash_multiply(hash, right_power), right->value.hash);
+      reversed_hash = detail::hash_add(
+        detail::hash_multiply(right->value.reversed_hash,
+          detail::hash_multiply(left_power, detail::kHashBase)),
+        reversed_hash);
+    }
+    value.hash = hash;
+    value.reversed_hash = reversed_hash;
+    value.power = detail::hash_multiply(
+      detail::hash_multiply(left_power, right_power), detail::kHashBase);
+  }
+};
+
+template <typename T, typename Hasher = std::hash<T>>
+using hashed_sequence = implicit_splay_tree<hashed_value<T, Hasher>>;
+
+// Hash of a contiguous range of a hashed sequence. Equal ranges have equal
+// hashes, different ranges collide with probability about length / 2^61
+struct sequence_hash {
+  uint64_t hash;
+  uint64_t reversed_hash;
+  uint64_t size;
+};
+
+inline bool operator == (const sequence_hash& lhs, const sequence_hash& rhs) noexcept {
+  return lhs.size == rhs.size && lhs.hash == rhs.hash;
+}
+
+inline bool operator != (const sequence_hash& lhs, const sequence_hash& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+// hash of the elements at positions [first, last) of `sequence`
+// the range is cut out with two splits and glued back, so the tree is rebalanced
+template <typename T, typename Hasher>
+sequence_hash range_hash(hashed_sequence<T, Hasher>& sequence, size_t first, size_t last) {
+  assert(first <= last);
+  assert(last <= sequence.size());
+  auto result = sequence_hash{uint64_t{0}, uint64_t{0}, uint64_t{0}};
+  auto middle_right = sequence.split_right(sequence.order_statistic(first));
+  auto& left = sequence;
+  auto right = middle_right.split_right(middle_right.order_statistic(last - first));
+  auto& middle = middle_right;
+  if (!middle.empty()) {
+    const auto& value = middle.root()->value;
+    result = sequence_hash{value.hash, value.reversed_hash, middle.size()};
+  }
+  middle.merge(right);
+  left.merge(middle);
+  return result;
+}
+
+// check if `count` elements of `lhs` starting at `lhs_first` are equal to
+// `count` elements of `rhs` starting at `rhs_first`
+template <typename T, typename Hasher>
+bool equal_ranges(
+    hashed_sequence<T, Hasher>& lhs,
+    size_t lhs_first,
+    hashed_sequence<T, Hasher>& rhs,
+    size_t rhs_first,
+    size_t count) {
+  return range_hash(lhs, lhs_first, lhs_first + count) ==
+         range_hash(rhs, rhs_first, rhs_first + count);
+}
+
+// check if elements at positions [first, last) of `sequence` form a palindrome
+template <typename T, typename Hasher>
+bool is_palindrome(hashed_sequence<T, Hasher>& sequence, size_t first, size_t last) {
+  const auto hash = range_hash(sequence, first, last);
+  return hash.hash == hash.reversed_hash;
+}
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SEQUENCE_HASH_H_
@@ -0,0 +1,83 @@
+#ifndef SPLAY_TREE_SLIDING_WINDOW_H_
+#define SPLAY_TREE_SLIDING_WINDOW_H_
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+
+namespace splay {
+
+namespace detail {
+
+// Arrival order of the elements of a sliding window. The window keeps at most
+// `max_count` elements (0 for unbounded) and only elements whose timestamp is
+// greater than `now - max_age` after `expire(now)` (0 age for unbounded).
+// Elements are identified by handles, usually nodes of the tree holding them,
+// and `drop(handle)` is called for every element leaving the window
+template <typename Handle>
+class window_arrivals {
+  struct arrival {
+    Handle handle;
+    int64_t timestamp;
+  };
+
+ public:
+  window_arrivals(size_t max_count, int64_t max_age)
+    : arrivals{}
+    , max_count{max_count}
+    , max_age{max_age}
+  {}
+
+  size_t size() const noexcept {
+    return arrivals.size();
+  }
+
+  bool empty() const noexcept {
+    return arrivals.empty();
+  }
+
+  void clear() noexcept {
+    arrivals.clear();
+  }
+
+  // add `handle` observed at `timestamp`, timestamps must not decrease
+  // the oldest element is dropped if the window is full
+  template <typename Drop>
+  void push(Handle handle, int64_t timestamp, Drop drop) {
+    assert(arrivals.empty() || arrivals.back().timestamp <= timestamp);
+    arrivals.push_back(arrival{handle, timestamp});
+    if (max_count != 0 && arrivals.size() > max_count) {
+      this->pop_oldest(drop);
+    }
+    this->expire(timestamp, drop);
+  }
+
+  // drop elements with timestamps not greater than `now - max_age`
+  template <typename Drop>
+  void expire(int64_t now, Drop drop) {
+    if (max_age == 0) {
+      return;
+    }
+    while (!arrivals.empty() && arrivals.front().timestamp <= now - max_age) {
+      this->pop_oldest(drop);
+    }
+  }
+
+ private:
+  template <typename Drop>
+  void pop_oldest(Drop& drop) {
+    const auto handle = arrivals.front().handle;
+    arrivals.pop_front();
+    drop(handle);
+  }
+
+  std::deque<arrival> arrivals;
+  size_t max_count;
+  int64_t max_age;
+};
+
+}  // namespace detail
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SLIDING_WINDOW_H_
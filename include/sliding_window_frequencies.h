@@ -0,0 +1,190 @@
+#ifndef SPLAY_TREE_SLIDING_WINDOW_FREQUENCIES_H_
+#define SPLAY_TREE_SLIDING_WINDOW_FREQUENCIES_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "sliding_window.h"
+#include "splay_tree.h"
+
+namespace splay {
+
+template <typename Key>
+struct key_frequency {
+  Key key;
+  size_t count;
+};
+
+template <typename Key>
+std::ostream& operator << (std::ostream& out, const key_frequency<Key>& frequency) {
+  out << frequency.key << ":" << frequency.count;
+  return out;
+}
+
+// Distinct keys and most frequent keys among the last elements of a stream,
+// with the same window bounds as `sliding_window_quantiles`. Every distinct key
+// has a multiplicity in a splay tree keyed by key and a node in an order
+// statistic splay tree ordered by (count descending, key). A count change
+// relinks the ranking node, so a push or expiry costs O(log d) amortized in
+// the number of distinct keys `d` and the top `k` keys are read in O(log d + k)
+template <typename Key, typename Compare = std::less<Key>>
+class sliding_window_frequencies {
+  using frequency_type = key_frequency<Key>;
+  using ranked_node_type = tree_node<frequency_type>;
+
+  struct counted_key {
+    Key key;
+    size_t count;
+    ranked_node_type* ranked;
+
+    friend std::ostream& operator << (std::ostream& out, const counted_key& value) {
+      out << value.key << ":" << value.count;
+      return out;
+    }
+  };
+
+  struct counted_key_extractor {
+    const Key& operator () (const counted_key& value) const noexcept {
+      return value.key;
+    }
+  };
+
+  struct frequency_extractor {
+    const frequency_type& operator () (const frequency_type& value) const noexcept {
+      return value;
+    }
+  };
+
+  struct frequency_comparator {
+    bool operator () (const frequency_type& lhs, const frequency_type& rhs) const {
+      if (lhs.count != rhs.count) {
+        return lhs.count > rhs.count;
+      }
+      return compare(lhs.key, rhs.key);
+    }
+
+    Compare compare;
+  };
+
+ public:
+  using counts_tree_type = splay_tree<Key, counted_key, Compare, counted_key_extractor>;
+  using ranking_tree_type = splay_tree<
+    frequency_type, frequency_type, frequency_comparator, frequency_extractor>;
+
+ private:
+  using counted_node_type = tree_node<counted_key>;
+
+ public:
+  explicit sliding_window_frequencies(
+      size_t max_count, int64_t max_age = 0, const Compare& compare = Compare{})
+    : counts{compare, counted_key_extractor{}}
+    , ranking{frequency_comparator{compare}, frequency_extractor{}}
+    , arrivals{max_count, max_age}
+  {}
+
+  // arrivals and counts point into the trees, so the window can't be copied
+  sliding_window_frequencies(const sliding_window_frequencies& other) = delete;
+  sliding_window_frequencies(sliding_window_frequencies&& other) = default;
+  sliding_window_frequencies& operator = (const sliding_window_frequencies& other) = delete;
+  sliding_window_frequencies& operator = (sliding_window_frequencies&& other) = default;
+
+  // number of elements in the window
+  size_t size() const noexcept {
+    return arrivals.size();
+  }
+
+  bool empty() const noexcept {
+    return arrivals.empty();
+  }
+
+  // number of distinct keys in the window
+  size_t distinct_count() const noexcept {
+    return counts.size();
+  }
+
+  void clear() noexcept {
+    counts.clear();
+    ranking.clear();
+    arrivals.clear();
+  }
+
+  // add `key` observed at `timestamp`, timestamps must not decrease
+  // the oldest element is dropped if the window is full
+  void push(const Key& key, int64_t timestamp = 0) {
+    auto node = counts.find(key);
+    if (node == nullptr) {
+      node = counts.insert(counted_key{key, 1, nullptr});
+      node->value.ranked = ranking.insert(frequency_type{key, 1});
+    } else {
+      this->recount(node, node->value.count + 1);
+    }
+    arrivals.push(node, timestamp, [this](counted_node_type* oldest) {
+      this->drop(oldest);
+    });
+  }
+
+  // drop elements with timestamps not greater than `now - max_age`
+  void expire(int64_t now) {
+    arrivals.expire(now, [this](counted_node_type* oldest) {
+      this->drop(oldest);
+    });
+  }
+
+  // number of occurrences of `key` in the window
+  size_t frequency(const Key& key) {
+    auto node = counts.find(key);
+    return node != nullptr ? node->value.count : size_t{0};
+  }
+
+  // at most `k` most frequent keys, ties go in key order
+  std::vector<frequency_type> top_k(size_t k) {
+    auto result = std::vector<frequency_type>{};
+    if (k == 0) {
+      return result;
+    }
+    const ranked_node_type* node = ranking.order_statistic(0);
+    while (node != nullptr && result.size() < k) {
+      result.push_back(node->value);
+      node = node->next_node();
+    }
+    return result;
+  }
+
+  const counts_tree_type& get_counts_tree() const noexcept {
+    return counts;
+  }
+
+  const ranking_tree_type& get_ranking_tree() const noexcept {
+    return ranking;
+  }
+
+ private:
+  // move the ranking node of `node` to its new count without reallocating it
+  void recount(counted_node_type* node, size_t count) noexcept {
+    auto ranked = ranking.detach(node->value.ranked);
+    node->value.count = count;
+    ranked->value.count = count;
+    ranking.insert_node(ranked);
+  }
+
+  // an element with the key of `node` left the window
+  void drop(counted_node_type* node) noexcept {
+    if (node->value.count == 1) {
+      ranking.erase(node->value.ranked);
+      counts.erase(node);
+    } else {
+      this->recount(node, node->value.count - 1);
+    }
+  }
+
+  counts_tree_type counts;
+  ranking_tree_type ranking;
+  detail::window_arrivals<counted_node_type*> arrivals;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SLIDING_WINDOW_FREQUENCIES_H_
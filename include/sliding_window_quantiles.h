@@ -0,0 +1,130 @@
+#ifndef SPLAY_TREE_SLIDING_WINDOW_QUANTILES_H_
+#define SPLAY_TREE_SLIDING_WINDOW_QUANTILES_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+
+#include "sliding_window.h"
+#include "splay_tree.h"
+
+namespace splay {
+
+// element of a multiset tree, equal values are told apart by arrival order
+template <typename T>
+struct window_sample {
+  T value;
+  uint64_t sequence;
+};
+
+template <typename T>
+std::ostream& operator << (std::ostream& out, const window_sample<T>& sample) {
+  out << sample.value;
+  return out;
+}
+
+// Quantiles of the last elements of a stream. The window keeps at most
+// `max_count` elements (0 for unbounded) and only elements whose timestamp is
+// greater than `now - max_age` after `expire(now)` (0 age for unbounded).
+// Elements are kept in an order statistic splay tree, so every push, expiry
+// and quantile query costs O(log n) amortized
+template <typename T, typename Compare = std::less<T>>
+class sliding_window_quantiles {
+  using sample_type = window_sample<T>;
+
+  struct sample_extractor {
+    const sample_type& operator () (const sample_type& sample) const noexcept {
+      return sample;
+    }
+  };
+
+  struct sample_comparator {
+    bool operator () (const sample_type& lhs, const sample_type& rhs) const {
+      if (compare(lhs.value, rhs.value)) {
+        return true;
+      }
+      if (compare(rhs.value, lhs.value)) {
+        return false;
+      }
+      return lhs.sequence < rhs.sequence;
+    }
+
+    Compare compare;
+  };
+
+  using tree_type = splay_tree<sample_type, sample_type, sample_comparator, sample_extractor>;
+  using node_type = tree_node<sample_type>;
+
+ public:
+  explicit sliding_window_quantiles(
+      size_t max_count, int64_t max_age = 0, const Compare& compare = Compare{})
+    : tree{sample_comparator{compare}, sample_extractor{}}
+    , arrivals{max_count, max_age}
+    , next_sequence{0}
+  {}
+
+  // arrivals point into the tree, so the window can't be copied
+  sliding_window_quantiles(const sliding_window_quantiles& other) = delete;
+  sliding_window_quantiles(sliding_window_quantiles&& other) = default;
+  sliding_window_quantiles& operator = (const sliding_window_quantiles& other) = delete;
+  sliding_window_quantiles& operator = (sliding_window_quantiles&& other) = default;
+
+  size_t size() const noexcept {
+    return tree.size();
+  }
+
+  bool empty() const noexcept {
+    return tree.empty();
+  }
+
+  void clear() noexcept {
+    tree.clear();
+    arrivals.clear();
+  }
+
+  // add `value` observed at `timestamp`, timestamps must not decrease
+  // the oldest element is dropped if the window is full
+  void push(const T& value, int64_t timestamp = 0) {
+    auto node = tree.insert(sample_type{value, next_sequence++});
+    arrivals.push(node, timestamp, [this](node_type* oldest) {
+      tree.erase(oldest);
+    });
+  }
+
+  // drop elements with timestamps not greater than `now - max_age`
+  void expire(int64_t now) {
+    arrivals.expire(now, [this](node_type* oldest) {
+      tree.erase(oldest);
+    });
+  }
+
+  // element of rank floor(q * (size - 1)) in the window, `q` is in [0, 1]
+  const T& quantile(double q) {
+    assert(!this->empty());
+    assert(0.0 <= q && q <= 1.0);
+    const auto rank = static_cast<size_t>(q * static_cast<double>(this->size() - 1));
+    return tree.order_statistic(rank)->value.value;
+  }
+
+  const T& median() {
+    return this->quantile(0.5);
+  }
+
+  const T& min() {
+    return this->quantile(0.0);
+  }
+
+  const T& max() {
+    return this->quantile(1.0);
+  }
+
+ private:
+  tree_type tree;
+  detail::window_arrivals<node_type*> arrivals;
+  uint64_t next_sequence;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SLIDING_WINDOW_QUANTILES_H_
@@ -0,0 +1,287 @@
+#ifndef SPLAY_TREE_SPLAY_LRU_CACHE_H_
+#define SPLAY_TREE_SPLAY_LRU_CACHE_H_
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "node_pool.h"
+#include "tree_impl.h"
+
+namespace splay {
+
+// every entry weighs one, capacity is the number of entries
+struct lru_unit_weigher {
+  template <typename Key, typename Value>
+  size_t operator () (const Key&, const Value&) const noexcept {
+    return size_t{1};
+  }
+};
+
+struct lru_cache_statistics {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint64_t expirations;
+};
+
+// Cache of bounded total weight evicting the least recently accessed entry.
+// Entries live in a splay tree ordered by key, their access order in a second
+// splay tree ordered by access stamp. Fresh stamps always go to the right end
+// and the oldest entry is the leftmost node, so recency updates and evictions
+// touch the ends of the recency tree. Evicted nodes go to small node pools and
+// are reused by the following insertions, pooled nodes drop their values.
+// With nonzero `ttl` entries expire `ttl` after they were put, reads don't
+// extend their lifetime
+template <
+  typename Key,
+  typename Value,
+  typename KeyComparator = std::less<Key>,
+  typename Weigher = lru_unit_weigher,
+  typename Clock = std::chrono::steady_clock>
+class splay_lru_cache {
+  using self = splay_lru_cache<Key, Value, KeyComparator, Weigher, Clock>;
+  using time_point = typename Clock::time_point;
+  using duration = typename Clock::duration;
+
+  struct recency;
+
+  struct entry {
+    Key key;
+    Value value;
+    size_t weight;
+    time_point expires;
+    tree_node<recency>* recency_node;
+  };
+
+  struct recency {
+    uint64_t stamp;
+    tree_node<entry>* entry_node;
+  };
+
+  struct entry_key_extractor {
+    const Key& operator () (const entry& value) const noexcept {
+      return value.key;
+    }
+  };
+
+  struct recency_key_extractor {
+    uint64_t operator () (const recency& value) const noexcept {
+      return value.stamp;
+    }
+  };
+
+  using entry_node = tree_node<entry>;
+  using recency_node = tree_node<recency>;
+
+  // evicted nodes kept for reuse, the rest go back to the allocator
+  static constexpr size_t kMaxPooledNodes = 64;
+
+ public:
+  explicit splay_lru_cache(
+      size_t capacity,
+      duration ttl = duration::zero(),
+      const KeyComparator& comparator = KeyComparator{},
+      const Weigher& weigher = Weigher{})
+    : entries{detail::create_tree<entry>()}
+    , recencies{detail::create_tree<recency>()}
+    , entry_pool{kMaxPooledNodes}
+    , recency_pool{kMaxPooledNodes}
+    , comparator{comparator}
+    , weigher{weigher}
+    , max_weight{capacity}
+    , total_weight{0}
+    , time_to_live{ttl}
+    , next_stamp{0}
+    , stats{0, 0, 0, 0}
+  {}
+
+  splay_lru_cache(const self& other) = delete;
+
+  splay_lru_cache(self&& other) noexcept
+    : splay_lru_cache{size_t{0}} {
+    this->swap(other);
+  }
+
+  self& operator = (const self& other) = delete;
+
+  self& operator = (self&& other) noexcept {
+    this->swap(other);
+    return *this;
+  }
+
+  ~splay_lru_cache() {
+    this->clear();
+  }
+
+  size_t size() const noexcept {
+    return detail::get_size_tree(entries);
+  }
+
+  bool empty() const noexcept {
+    return detail::is_empty_tree(entries);
+  }
+
+  size_t weight() const noexcept {
+    return total_weight;
+  }
+
+  size_t capacity() const noexcept {
+    return max_weight;
+  }
+
+  const lru_cache_statistics& statistics() const noexcept {
+    return stats;
+  }
+
+  // return the value cached for `key` and mark it as the most recently used
+  // null if there is no such entry or it has expired
+  // the pointer is valid until the next modification of the cache
+  Value* get(const Key& key) {
+    auto node = this->find_entry(key);
+    if (node == nullptr) {
+      ++stats.misses;
+      return nullptr;
+    }
+    ++stats.hits;
+    this->touch(node);
+    return std::addressof(node->value.value);
+  }
+
+  // check presence of `key` without changing the recency order or statistics
+  bool contains(const Key& key) {
+    auto node = detail::find_tree(entries, key, comparator, entry_key_extractor{});
+    return node != nullptr && !this->expired(node->value);
+  }
+
+  // insert or overwrite the entry for `key` evicting the least recently used
+  // entries until it fits. Entries heavier than the capacity are not cached
+  bool put(const Key& key, const Value& value) {
+    const auto entry_weight = weigher(key, value);
+    auto node = detail::find_tree(entries, key, comparator, entry_key_extractor{});
+    if (entry_weight > max_weight) {
+      if (node != nullptr) {
+        this->remove(node);
+      }
+      return false;
+    }
+    const auto expires = this->expiration_time();
+    if (node != nullptr) {
+      total_weight -= node->value.weight;
+      node->value.value = value;
+      node->value.weight = entry_weight;
+      node->value.expires = expires;
+      total_weight += entry_weight;
+      this->touch(node);
+      while (total_weight > max_weight) {
+        this->evict();
+      }
+      return true;
+    }
+    while (total_weight + entry_weight > max_weight) {
+      this->evict();
+    }
+    node = entry_pool.acquire(entry{key, value, entry_weight, expires, nullptr});
+    auto stamp = recency_pool.acquire(recency{next_stamp++, node});
+    node->value.recency_node = stamp;
+    detail::insert_node_tree<Key, entry, KeyComparator, entry_key_extractor>(
+      entries, node, comparator, entry_key_extractor{});
+    detail::insert_node_tree<uint64_t, recency, std::less<uint64_t>, recency_key_extractor>(
+      recencies, stamp, std::less<uint64_t>{}, recency_key_extractor{});
+    total_weight += entry_weight;
+    return true;
+  }
+
+  bool erase(const Key& key) {
+    auto node = detail::find_tree(entries, key, comparator, entry_key_extractor{});
+    if (node == nullptr) {
+      return false;
+    }
+    this->remove(node);
+    return true;
+  }
+
+  void swap(self& other) noexcept {
+    auto* const cache = this;
+    detail::swap_trees(cache->entries, other.entries);
+    detail::swap_trees(cache->recencies, other.recencies);
+    cache->entry_pool.swap(other.entry_pool);
+    cache->recency_pool.swap(other.recency_pool);
+    std::swap(cache->comparator, other.comparator);
+    std::swap(cache->weigher, other.weigher);
+    std::swap(cache->max_weight, other.max_weight);
+    std::swap(cache->total_weight, other.total_weight);
+    std::swap(cache->time_to_live, other.time_to_live);
+    std::swap(cache->next_stamp, other.next_stamp);
+    std::swap(cache->stats, other.stats);
+  }
+
+  void clear() noexcept {
+    detail::clear_tree(entries);
+    detail::clear_tree(recencies);
+    entry_pool.clear();
+    recency_pool.clear();
+    total_weight = 0;
+  }
+
+ private:
+  time_point expiration_time() const {
+    return time_to_live != duration::zero() ? Clock::now() + time_to_live : time_point::max();
+  }
+
+  bool expired(const entry& value) const {
+    return time_to_live != duration::zero() && value.expires <= Clock::now();
+  }
+
+  entry_node* find_entry(const Key& key) {
+    auto node = detail::find_tree(entries, key, comparator, entry_key_extractor{});
+    if (node != nullptr && this->expired(node->value)) {
+      ++stats.expirations;
+      this->remove(node);
+      node = nullptr;
+    }
+    return node;
+  }
+
+  // move the entry to the right end of the recency tree
+  void touch(entry_node* node) noexcept {
+    auto stamp = detail::detach_tree(recencies, node->value.recency_node);
+    stamp->value.stamp = next_stamp++;
+    detail::insert_node_tree<uint64_t, recency, std::less<uint64_t>, recency_key_extractor>(
+      recencies, stamp, std::less<uint64_t>{}, recency_key_extractor{});
+  }
+
+  void remove(entry_node* node) noexcept {
+    total_weight -= node->value.weight;
+    recency_pool.release(detail::detach_tree(recencies, node->value.recency_node));
+    entry_pool.release(detail::detach_tree(entries, node));
+  }
+
+  void evict() noexcept {
+    assert(!detail::is_empty_tree(recencies));
+    auto oldest = detail::order_statistic_tree(recencies, 0);
+    ++stats.evictions;
+    this->remove(oldest->value.entry_node);
+  }
+
+  detail::splay_tree_base<entry> entries;
+  detail::splay_tree_base<recency> recencies;
+  node_pool<entry> entry_pool;
+  node_pool<recency> recency_pool;
+  KeyComparator comparator;
+  Weigher weigher;
+  size_t max_weight;
+  size_t total_weight;
+  duration time_to_live;
+  uint64_t next_stamp;
+  lru_cache_statistics stats;
+};
+
+template <typename Key, typename Value, typename KeyComparator, typename Weigher, typename Clock>
+constexpr size_t splay_lru_cache<Key, Value, KeyComparator, Weigher, Clock>::kMaxPooledNodes;
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SPLAY_LRU_CACHE_H_
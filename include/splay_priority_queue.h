@@ -0,0 +1,219 @@
+#ifndef SPLAY_TREE_SPLAY_PRIORITY_QUEUE_H_
+#define SPLAY_TREE_SPLAY_PRIORITY_QUEUE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <utility>
+
+#include "tree_impl.h"
+
+namespace splay {
+
+template <typename T>
+struct queued_value {
+  T value;
+  uint64_t sequence;
+};
+
+template <typename T>
+std::ostream& operator << (std::ostream& out, const queued_value<T>& item) {
+  out << item.value;
+  return out;
+}
+
+// Double-ended priority queue on a splay tree. Equal values leave in the order
+// they were pushed. After an extreme element is splayed to the root the next
+// one is its child, so runs of pops from one end cost O(1) amortized each.
+// `push` returns a handle that stays valid until the element is popped or
+// erased, including across `update` and `meld`
+template <typename T, typename Compare = std::less<T>>
+class splay_priority_queue {
+  using self = splay_priority_queue<T, Compare>;
+  using item_type = queued_value<T>;
+
+  struct item_extractor {
+    const item_type& operator () (const item_type& item) const noexcept {
+      return item;
+    }
+  };
+
+  struct item_comparator {
+    bool operator () (const item_type& lhs, const item_type& rhs) const {
+      if (compare(lhs.value, rhs.value)) {
+        return true;
+      }
+      if (compare(rhs.value, lhs.value)) {
+        return false;
+      }
+      return lhs.sequence < rhs.sequence;
+    }
+
+    Compare compare;
+  };
+
+ public:
+  using handle_type = tree_node<item_type>*;
+
+  splay_priority_queue()
+    : splay_priority_queue(Compare{})
+  {}
+
+  explicit splay_priority_queue(const Compare& compare)
+    : impl{detail::create_tree<item_type>()}
+    , comparator{compare}
+    , next_sequence{0}
+  {}
+
+  // handles refer to nodes of this queue, so it can't be copied
+  splay_priority_queue(const self& other) = delete;
+
+  splay_priority_queue(self&& other) noexcept
+    : splay_priority_queue{} {
+    this->swap(other);
+  }
+
+  self& operator = (const self& other) = delete;
+
+  self& operator = (self&& other) noexcept {
+    this->swap(other);
+    return *this;
+  }
+
+  ~splay_priority_queue() {
+    this->clear();
+  }
+
+  size_t size() const noexcept {
+    return detail::get_size_tree(impl);
+  }
+
+  bool empty() const noexcept {
+    return detail::is_empty_tree(impl);
+  }
+
+  handle_type push(const T& value) {
+    return detail::insert_tree<item_type, item_type, item_comparator, item_extractor>(
+      impl, item_type{value, next_sequence++}, comparator, item_extractor{});
+  }
+
+  const T& top_min() noexcept {
+    return this->min_node()->value.value;
+  }
+
+  const T& top_max() noexcept {
+    return this->max_node()->value.value;
+  }
+
+  T pop_min() {
+    auto node = this->min_node();
+    auto value = std::move(node->value.value);
+    detail::erase_tree(impl, node);
+    return value;
+  }
+
+  T pop_max() {
+    auto node = this->max_node();
+    auto value = std::move(node->value.value);
+    detail::erase_tree(impl, node);
+    return value;
+  }
+
+  const T& get(handle_type handle) const noexcept {
+    return handle->value.value;
+  }
+
+  // remove the element behind `handle` from the queue
+  void erase(handle_type handle) noexcept {
+    detail::erase_tree(impl, handle);
+  }
+
+  // change the value behind `handle`, the handle stays valid
+  // among equal values the updated element goes last
+  void update(handle_type handle, const T& value) {
+    auto node = detail::detach_tree(impl, handle);
+    node->value = item_type{value, next_sequence++};
+    node_augmentation<item_type>::update(node);
+    auto inserted = detail::insert_node_tree<item_type, item_type, item_comparator, item_extractor>(
+      impl, node, comparator, item_extractor{});
+    assert(inserted == node);
+    (void)inserted;
+  }
+
+  void decrease_key(handle_type handle, const T& value) {
+    assert(!comparator.compare(handle->value.value, value));
+    this->update(handle, value);
+  }
+
+  void increase_key(handle_type handle, const T& value) {
+    assert(!comparator.compare(value, handle->value.value));
+    this->update(handle, value);
+  }
+
+  // move all elements of `other` into this queue, handles of `other` stay valid
+  // if all elements of one queue precede all elements of the other the trees
+  // are concatenated in O(log n), otherwise the nodes of `other` are relinked
+  // one by one in O(m log (n + m)) without reallocation. Elements of `other`
+  // go after equal elements of this queue
+  void meld(self& other) {
+    if (other.empty()) {
+      return;
+    }
+    // keep sequences of later pushes above the sequences of moved elements
+    next_sequence = next_sequence < other.next_sequence ? other.next_sequence : next_sequence;
+    if (this->empty()) {
+      detail::swap_trees(impl, other.impl);
+      return;
+    }
+    if (comparator.compare(this->max_node()->value.value, other.min_node()->value.value)) {
+      detail::merge_trees(impl, other.impl);
+      return;
+    }
+    if (comparator.compare(other.max_node()->value.value, this->min_node()->value.value)) {
+      detail::merge_trees(other.impl, impl);
+      detail::swap_trees(impl, other.impl);
+      return;
+    }
+    while (!other.empty()) {
+      auto node = detail::detach_tree(other.impl, other.min_node());
+      node->value.sequence = next_sequence++;
+      detail::insert_node_tree<item_type, item_type, item_comparator, item_extractor>(
+        impl, node, comparator, item_extractor{});
+    }
+  }
+
+  void swap(self& other) noexcept {
+    auto* const queue = this;
+    detail::swap_trees(queue->impl, other.impl);
+    std::swap(queue->comparator, other.comparator);
+    std::swap(queue->next_sequence, other.next_sequence);
+  }
+
+  void clear() noexcept {
+    detail::clear_tree(impl);
+  }
+
+ private:
+  tree_node<item_type>* min_node() noexcept {
+    assert(!this->empty());
+    auto node = impl.root->leftmost_node();
+    detail::splay_node_tree(impl, node);
+    return node;
+  }
+
+  tree_node<item_type>* max_node() noexcept {
+    assert(!this->empty());
+    auto node = impl.root->rightmost_node();
+    detail::splay_node_tree(impl, node);
+    return node;
+  }
+
+  detail::splay_tree_base<item_type> impl;
+  item_comparator comparator;
+  uint64_t next_sequence;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SPLAY_PRIORITY_QUEUE_H_
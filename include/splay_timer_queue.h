@@ -0,0 +1,201 @@
+#ifndef SPLAY_TREE_SPLAY_TIMER_QUEUE_H_
+#define SPLAY_TREE_SPLAY_TIMER_QUEUE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+#include "tree_impl.h"
+
+namespace splay {
+
+template <typename Deadline, typename Payload>
+struct scheduled_timer {
+  Deadline deadline;
+  uint64_t sequence;
+  Payload payload;
+};
+
+template <typename Deadline, typename Payload>
+std::ostream& operator << (std::ostream& out, const scheduled_timer<Deadline, Payload>& timer) {
+  out << timer.deadline;
+  return out;
+}
+
+namespace detail {
+
+template <typename Deadline, typename Payload>
+struct timer_key_extractor {
+  std::pair<Deadline, uint64_t> operator () (
+      const scheduled_timer<Deadline, Payload>& timer) const {
+    return std::make_pair(timer.deadline, timer.sequence);
+  }
+};
+
+}  // namespace detail
+
+// Timers detached from a queue by `expire_until`, in deadline order. The batch
+// owns their nodes, handles of expired timers stay valid until it is destroyed
+template <typename Deadline, typename Payload>
+class timer_batch {
+  using self = timer_batch<Deadline, Payload>;
+  using timer_type = scheduled_timer<Deadline, Payload>;
+
+ public:
+  timer_batch() noexcept
+    : impl{detail::create_tree<timer_type>()}
+  {}
+
+  explicit timer_batch(detail::splay_tree_base<timer_type> timers) noexcept
+    : impl{timers}
+  {}
+
+  timer_batch(const self& other) = delete;
+
+  timer_batch(self&& other) noexcept
+    : timer_batch{} {
+    detail::swap_trees(impl, other.impl);
+  }
+
+  self& operator = (const self& other) = delete;
+
+  self& operator = (self&& other) noexcept {
+    detail::swap_trees(impl, other.impl);
+    return *this;
+  }
+
+  ~timer_batch() {
+    detail::clear_tree(impl);
+  }
+
+  size_t size() const noexcept {
+    return detail::get_size_tree(impl);
+  }
+
+  bool empty() const noexcept {
+    return detail::is_empty_tree(impl);
+  }
+
+  // call `visitor` for every expired timer in deadline order
+  template <typename Visitor>
+  void for_each(Visitor visitor) const {
+    if (impl.root == nullptr) {
+      return;
+    }
+    for (auto node = impl.root->leftmost_node(); node != nullptr; node = node->next_node()) {
+      visitor(node->value);
+    }
+  }
+
+ private:
+  detail::splay_tree_base<timer_type> impl;
+};
+
+// Timers ordered by deadline, equal deadlines fire in scheduling order.
+// `expire_until` detaches all due timers with a single split at the first
+// timer that is not due, so an expiry burst of `k` timers costs O(log n)
+// amortized to detach plus O(k) to walk
+template <typename Deadline, typename Payload>
+class splay_timer_queue {
+  using self = splay_timer_queue<Deadline, Payload>;
+  using timer_type = scheduled_timer<Deadline, Payload>;
+  using key_type = std::pair<Deadline, uint64_t>;
+  using key_extractor = detail::timer_key_extractor<Deadline, Payload>;
+  using key_comparator = std::less<key_type>;
+
+ public:
+  using handle_type = tree_node<timer_type>*;
+  using batch_type = timer_batch<Deadline, Payload>;
+
+  splay_timer_queue()
+    : impl{detail::create_tree<timer_type>()}
+    , next_sequence{0}
+  {}
+
+  // handles refer to nodes of this queue, so it can't be copied
+  splay_timer_queue(const self& other) = delete;
+
+  splay_timer_queue(self&& other) noexcept
+    : splay_timer_queue{} {
+    this->swap(other);
+  }
+
+  self& operator = (const self& other) = delete;
+
+  self& operator = (self&& other) noexcept {
+    this->swap(other);
+    return *this;
+  }
+
+  ~splay_timer_queue() {
+    this->clear();
+  }
+
+  size_t size() const noexcept {
+    return detail::get_size_tree(impl);
+  }
+
+  bool empty() const noexcept {
+    return detail::is_empty_tree(impl);
+  }
+
+  // the handle stays valid until the timer is cancelled or its batch destroyed
+  handle_type schedule(const Deadline& deadline, const Payload& payload) {
+    return detail::insert_tree<key_type, timer_type, key_comparator, key_extractor>(
+      impl, timer_type{deadline, next_sequence++, payload}, key_comparator{}, key_extractor{});
+  }
+
+  void cancel(handle_type handle) noexcept {
+    detail::erase_tree(impl, handle);
+  }
+
+  // move a pending timer to `deadline`, the handle stays valid
+  void reschedule(handle_type handle, const Deadline& deadline) {
+    auto node = detail::detach_tree(impl, handle);
+    node->value.deadline = deadline;
+    node->value.sequence = next_sequence++;
+    detail::insert_node_tree<key_type, timer_type, key_comparator, key_extractor>(
+      impl, node, key_comparator{}, key_extractor{});
+  }
+
+  // earliest pending timer, null if there is none
+  const timer_type* next() noexcept {
+    if (impl.root == nullptr) {
+      return nullptr;
+    }
+    auto node = impl.root->leftmost_node();
+    detail::splay_node_tree(impl, node);
+    return &node->value;
+  }
+
+  // detach all timers with deadlines not after `now`
+  batch_type expire_until(const Deadline& now) {
+    const auto bound = key_type{now, std::numeric_limits<uint64_t>::max()};
+    auto first_pending = detail::upper_bound_tree(impl, bound, key_comparator{}, key_extractor{});
+    auto pending = detail::split_right_tree(impl, first_pending);
+    auto expired = impl;
+    impl = pending;
+    return batch_type{expired};
+  }
+
+  void swap(self& other) noexcept {
+    auto* const queue = this;
+    detail::swap_trees(queue->impl, other.impl);
+    std::swap(queue->next_sequence, other.next_sequence);
+  }
+
+  void clear() noexcept {
+    detail::clear_tree(impl);
+  }
+
+ private:
+  detail::splay_tree_base<timer_type> impl;
+  uint64_t next_sequence;
+};
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SPLAY_TIMER_QUEUE_H_
@@ -1,8 +1,10 @@
 #ifndef SPLAY_TREE_SPLAY_TREE_H_
 #define SPLAY_TREE_SPLAY_TREE_H_
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 #include "tree_impl.h"
 
@@ -120,6 +122,78 @@ class splay_tree {
     return detail::order_statistic_tree(this->impl, n);
   }
 
+  // number of nodes with keys less than `key`
+  // the tree is not splayed, so concurrent readers are safe
+  size_t rank(const Key& key) const noexcept {
+    return detail::count_less_subtree(this->impl.root, key, this->comparator, this->extractor);
+  }
+
+  // `b + 1` keys at ranks i * (size - 1) / b for i in [0, b]: the minimum, the
+  // maximum and the boundaries of `b` buckets of equal size. Every key costs
+  // one descent without splaying, O(b log n) in total
+  std::vector<Key> quantile_summary(size_t b) const {
+    assert(b != 0);
+    auto keys = std::vector<Key>{};
+    if (this->empty()) {
+      return keys;
+    }
+    keys.reserve(b + 1);
+    const auto last = this->size() - 1;
+    for (auto idx = size_t{0}; idx <= b; ++idx) {
+      const node_type* node = detail::order_statistic_subtree(
+        static_cast<const node_type*>(this->impl.root), idx * last / b);
+      keys.push_back(this->extractor(node->value));
+    }
+    return keys;
+  }
+
+  // number of keys in every bucket cut by sorted `boundaries`: below
+  // boundaries[0], in [boundaries[i - 1], boundaries[i]) and not below the
+  // last boundary. One rank query per boundary without splaying, O(b log n)
+  std::vector<size_t> histogram(const std::vector<Key>& boundaries) const {
+    auto counts = std::vector<size_t>{};
+    counts.reserve(boundaries.size() + 1);
+    auto previous = size_t{0};
+    for (const auto& boundary : boundaries) {
+      const auto rank = this->rank(boundary);
+      assert(previous <= rank);
+      counts.push_back(rank - previous);
+      previous = rank;
+    }
+    counts.push_back(this->size() - previous);
+    return counts;
+  }
+
+  // nodes at ranks `ranks` in one traversal without splaying, the ranks are
+  // sorted first and the nodes are returned in key order, null for ranks
+  // not less than the size
+  std::vector<const node_type*> at_ranks(std::vector<size_t> ranks) const {
+    std::sort(std::begin(ranks), std::end(ranks));
+    return detail::order_statistics_subtree(static_cast<const node_type*>(this->impl.root), ranks);
+  }
+
+  // `k` nodes drawn uniformly with replacement, in key order
+  // the tree is not splayed, so sampling doesn't change its shape
+  template <typename RandomGenerator>
+  std::vector<const node_type*> sample(size_t k, RandomGenerator& generator) const {
+    return detail::order_statistics_subtree(
+      static_cast<const node_type*>(this->impl.root),
+      detail::sample_ranks(0, this->size(), k, generator));
+  }
+
+  // `k` nodes with keys in [low, high] drawn uniformly with replacement, in
+  // key order. Empty if there are no keys in the range
+  template <typename RandomGenerator>
+  std::vector<const node_type*> sample_range(
+      const Key& low, const Key& high, size_t k, RandomGenerator& generator) const {
+    const auto first = this->rank(low);
+    const auto last = detail::count_not_greater_subtree(
+      this->impl.root, high, this->comparator, this->extractor);
+    return detail::order_statistics_subtree(
+      static_cast<const node_type*>(this->impl.root),
+      detail::sample_ranks(first, last, k, generator));
+  }
+
   node_type* insert(const Value& value) {
     return detail::insert_tree<Key, Value, KeyComparator, KeyExtractor>(
       this->impl, value, this->comparator, this->extractor);
@@ -129,6 +203,18 @@ class splay_tree {
     return detail::erase_tree(this->impl, node);
   }
 
+  // unlink `node` without destroying it, it can be changed and linked again
+  // with `insert_node`, so rekeying a value doesn't reallocate its node
+  node_type* detach(node_type* node) noexcept {
+    return detail::detach_tree(this->impl, node);
+  }
+
+  // link detached `node`, returns null if its key is present
+  node_type* insert_node(node_type* node) noexcept {
+    return detail::insert_node_tree<Key, Value, KeyComparator, KeyExtractor>(
+      this->impl, node, this->comparator, this->extractor);
+  }
+
   self split_left(node_type* node) noexcept {
     auto right_tree = self{};
     right_tree.impl = detail::split_left_tree(this->impl, node);
@@ -146,6 +232,47 @@ class splay_tree {
     detail::merge_trees(this->impl, rhs.impl);
   }
 
+  // split the tree into `pivots.size() + 1` trees, the i-th tree gets the keys
+  // in [pivots[i - 1], pivots[i]), pivots must be sorted. The tree is left empty
+  std::vector<self> split_at_keys(const std::vector<Key>& pivots) {
+    auto trees = std::vector<self>(pivots.size() + 1, self{this->comparator, this->extractor});
+    auto pieces = detail::split_at_keys_tree(this->impl, pivots, this->comparator, this->extractor);
+    for (auto idx = size_t{0}; idx < pieces.size(); ++idx) {
+      trees[idx].impl = pieces[idx];
+    }
+    return trees;
+  }
+
+  // append `trees` in order after the nodes of this tree, every key of a tree
+  // must be less than the keys of the following trees. `trees` are left empty
+  // trees are merged from the right, so every merge splays the maximum of a
+  // single input tree and the whole join costs O(k log n) amortized
+  void concat(std::vector<self>& trees) {
+    if (trees.empty()) {
+      return;
+    }
+    for (auto idx = trees.size() - 1; idx > 0; --idx) {
+      assert(detail::is_less(trees[idx - 1].impl, trees[idx].impl, this->comparator, this->extractor));
+      detail::merge_trees(trees[idx - 1].impl, trees[idx].impl);
+    }
+    assert(detail::is_less(this->impl, trees.front().impl, this->comparator, this->extractor));
+    detail::merge_trees(this->impl, trees.front().impl);
+  }
+
+  // reshape the tree into a nearly optimal static search tree for positive
+  // node weights `weights` given in key order, heavy nodes go near the root.
+  // nodes are relinked, not reallocated. Takes O(n log n)
+  void rebuild_weighted(const std::vector<uint64_t>& weights) {
+    detail::rebuild_weighted_tree(this->impl, weights);
+  }
+
+  // move all nodes of `other` into this tree without copying, keys may
+  // interleave. Nodes of `other` with keys already present stay in `other`
+  void meld(self& other) {
+    detail::meld_trees<Key, Value, KeyComparator, KeyExtractor>(
+      this->impl, other.impl, this->comparator, this->extractor);
+  }
+
   void swap(self& other) noexcept {
     auto* const tree = this;
     detail::swap_trees(tree->impl, other.impl);
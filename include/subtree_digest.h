@@ -0,0 +1,218 @@
+#ifndef SPLAY_TREE_SUBTREE_DIGEST_H_
+#define SPLAY_TREE_SUBTREE_DIGEST_H_
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "splay_tree.h"
+
+namespace splay {
+namespace detail {
+
+inline uint64_t mix_digest(uint64_t hash) noexcept {
+  hash ^= hash >> 30;
+  hash *= uint64_t{0xbf58476d1ce4e5b9};
+  hash ^= hash >> 27;
+  hash *= uint64_t{0x94d049bb133111eb};
+  hash ^= hash >> 31;
+  return hash;
+}
+
+}  // namespace detail
+
+// Value of a digested tree. Every node stores the order independent digest
+// (sum of mixed element hashes modulo 2^64) of its subtree, so the digest of
+// any key range is obtained from the root after cutting the range out
+template <typename T, typename Hasher = std::hash<T>>
+struct digested_value {
+  digested_value(const T& element)
+    : element{element}
+    , element_digest{detail::mix_digest(Hasher{}(element))}
+    , digest{element_digest}
+  {}
+
+  T element;
+  uint64_t element_digest;
+  uint64_t digest;
+};
+
+template <typename T, typename Hasher>
+std::ostream& operator << (std::ostream& out, const digested_value<T, Hasher>& value) {
+  out << value.element;
+  return out;
+}
+
+template <typename T, typename Hasher>
+struct node_augmentation<digested_value<T, Hasher>> {
+  static void update(tree_node<digested_value<T, Hasher>>* node) noexcept {
+    auto& value = node->value;
+    value.digest = value.element_digest;
+    value.digest += (node->left != nullptr ? node->left->value.digest : uint64_t{0});
+    value.digest += (node->right != nullptr ? node->right->value.digest : uint64_t{0});
+  }
+};
+
+// Applies the key extractor of the plain tree to the wrapped element
+template <typename KeyExtractor>
+struct digested_key_extractor {
+  template <typename T, typename Hasher>
+  auto operator () (const digested_value<T, Hasher>& value) const
+      -> decltype(KeyExtractor{}(value.element)) {
+    return KeyExtractor{}(value.element);
+  }
+};
+
+template <
+  typename Key,
+  typename Value,
+  typename KeyComparator,
+  typename KeyExtractor,
+  typename Hasher = std::hash<Value>>
+using digested_splay_tree = splay_tree<
+  Key, digested_value<Value, Hasher>, KeyComparator, digested_key_extractor<KeyExtractor>>;
+
+struct range_digest {
+  uint64_t digest;
+  uint64_t count;
+};
+
+inline bool operator == (const range_digest& lhs, const range_digest& rhs) noexcept {
+  return lhs.count == rhs.count && lhs.digest == rhs.digest;
+}
+
+inline bool operator != (const range_digest& lhs, const range_digest& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+// digest of all elements of `tree` with keys in [*low, *high)
+// null `low` or `high` means the range is unbounded from that side
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+range_digest digest_range(
+    splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree,
+    const Key* low,
+    const Key* high) {
+  auto result = range_digest{uint64_t{0}, uint64_t{0}};
+  auto middle_right = splay_tree<Key, Value, KeyComparator, KeyExtractor>{
+    tree.key_comparator(), tree.key_extractor()};
+  if (low != nullptr) {
+    middle_right = tree.split_right(tree.lower_bound(*low));
+  } else {
+    middle_right.swap(tree);
+  }
+  auto& left = tree;
+  auto right = splay_tree<Key, Value, KeyComparator, KeyExtractor>{
+    tree.key_comparator(), tree.key_extractor()};
+  if (high != nullptr) {
+    right = middle_right.split_right(middle_right.lower_bound(*high));
+  }
+  auto& middle = middle_right;
+  if (!middle.empty()) {
+    result = range_digest{middle.root()->value.digest, middle.size()};
+  }
+  middle.merge(right);
+  left.merge(middle);
+  return result;
+}
+
+// Range of keys [low, high) reported by `diff`, `has_low`/`has_high` are false
+// for unbounded sides
+template <typename Key>
+struct digest_key_range {
+  bool has_low;
+  Key low;
+  bool has_high;
+  Key high;
+};
+
+// Digest source backed by a local tree, this is also what a replica answers
+// to `digest` requests of a remote `diff`
+template <typename Tree>
+class tree_digest_source {
+ public:
+  explicit tree_digest_source(Tree& tree) noexcept
+    : tree{tree}
+  {}
+
+  template <typename Key>
+  range_digest digest(const Key* low, const Key* high) {
+    return digest_range(tree, low, high);
+  }
+
+ private:
+  Tree& tree;
+};
+
+namespace detail {
+
+template <
+  typename Key,
+  typename Value,
+  typename KeyComparator,
+  typename KeyExtractor,
+  typename DigestSource>
+void diff_range(
+    splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree,
+    DigestSource& source,
+    const Key* low,
+    const Key* high,
+    size_t leaf_size,
+    std::vector<digest_key_range<Key>>& differences) {
+  const auto local = digest_range(tree, low, high);
+  const auto remote = source.digest(low, high);
+  if (local == remote) {
+    return;
+  }
+  if (local.count <= leaf_size || local.count < 2) {
+    auto range = digest_key_range<Key>{};
+    range.has_low = low != nullptr;
+    if (low != nullptr) {
+      range.low = *low;
+    }
+    range.has_high = high != nullptr;
+    if (high != nullptr) {
+      range.high = *high;
+    }
+    differences.push_back(range);
+    return;
+  }
+  // split at the local median, both halves are nonempty on this side
+  auto first = low != nullptr ? tree.lower_bound(*low) : tree.order_statistic(0);
+  assert(first != nullptr);
+  auto first_rank = first->left != nullptr ? first->left->size : size_t{0};
+  auto median = tree.order_statistic(first_rank + local.count / 2);
+  assert(median != nullptr);
+  const auto pivot = Key{tree.key_extractor()(median->value)};
+  diff_range(tree, source, low, &pivot, leaf_size, differences);
+  diff_range(tree, source, &pivot, high, leaf_size, differences);
+}
+
+}  // namespace detail
+
+// find key ranges where `tree` and the replica behind `source` disagree
+// `source.digest(low, high)` must return the digest of the replica keys in
+// [*low, *high) (null bound is unbounded), it is called O(d log(n / leaf_size))
+// times for `d` differing ranges. Ranges holding at most `leaf_size` local
+// elements are not narrowed down further and should be shipped as a whole
+template <
+  typename Key,
+  typename Value,
+  typename KeyComparator,
+  typename KeyExtractor,
+  typename DigestSource>
+std::vector<digest_key_range<Key>> diff(
+    splay_tree<Key, Value, KeyComparator, KeyExtractor>& tree,
+    DigestSource& source,
+    size_t leaf_size = 16) {
+  auto differences = std::vector<digest_key_range<Key>>{};
+  detail::diff_range(
+    tree, source, static_cast<const Key*>(nullptr), static_cast<const Key*>(nullptr),
+    leaf_size, differences);
+  return differences;
+}
+
+}  // namespace splay
+
+#endif  // SPLAY_TREE_SUBTREE_DIGEST_H_
@@ -1,8 +1,12 @@
 #ifndef SPLAY_TREE_TREE_IMPL_H_
 #define SPLAY_TREE_TREE_IMPL_H_
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include "tree_node.h"
 
@@ -20,17 +24,24 @@ void print_subtree(std::ostream& out, const tree_node<Value>* root) {
   out << ")";
 }
 
+// splay trees may degenerate into long paths, so the subtree is destroyed
+// iteratively: left children are rotated up until the root has none
 template <typename Value>
 void destroy_substree(tree_node<Value>* root) noexcept {
-  if (root == nullptr) {
-    return;
+  while (root != nullptr) {
+    if (root->left != nullptr) {
+      auto left = root->left;
+      root->left = left->right;
+      left->right = root;
+      root = left;
+    } else {
+      auto right = root->right;
+      root->right = nullptr;
+      root->parent = nullptr;
+      destroy_node(root);
+      root = right;
+    }
   }
-  destroy_substree(root->left);
-  root->left = nullptr;
-  destroy_substree(root->right);
-  root->right = nullptr;
-  root->parent = nullptr;
-  destroy_node(root);
 }
 
 template <typename Value>
@@ -39,6 +50,16 @@ void update_size(tree_node<Value>* node) noexcept {
     node->size = uint64_t{1};
     node->size += (node->left != nullptr ? node->left->size : uint64_t{0});
     node->size += (node->right != nullptr ? node->right->size : uint64_t{0});
+    node_augmentation<Value>::update(node);
+  }
+}
+
+// recompute size and augmentation of all nodes on the path from `node` to the root
+template <typename Value>
+void update_path(tree_node<Value>* node) noexcept {
+  while (node != nullptr) {
+    update_size(node);
+    node = node->parent;
   }
 }
 
@@ -79,12 +100,41 @@ tree_node<Value>* insert_subtree(
     }
   }
   if (node != nullptr) {
-    auto parent = node->parent;
-    while (parent != nullptr) {
-      parent->size += uint64_t{1};
-      parent = parent->parent;
+    update_path(node->parent);
+  }
+  return node;
+}
+
+// link detached node `node` into subtree at root `root`, no rebalancing
+// if the key of `node` is already present returns null and leaves `node` untouched
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+tree_node<Value>* link_subtree(
+    tree_node<Value>* root,
+    tree_node<Value>* node,
+    const KeyComparator& comparator,
+    const KeyExtractor& extractor) noexcept {
+  assert(root != nullptr);
+  assert(node != nullptr);
+  assert(node->parent == nullptr && node->left == nullptr && node->right == nullptr);
+  while (true) {
+    if (comparator(extractor(node->value), extractor(root->value))) {
+      if (root->left == nullptr) {
+        root->left = node;
+        break;
+      }
+      root = root->left;
+    } else if (comparator(extractor(root->value), extractor(node->value))) {
+      if (root->right == nullptr) {
+        root->right = node;
+        break;
+      }
+      root = root->right;
+    } else {
+      return nullptr;
     }
   }
+  node->parent = root;
+  update_path(root);
   return node;
 }
 
@@ -307,6 +357,107 @@ tree_node<Value>* order_statistic_subtree(tree_node<Value>* root, size_t n) noex
   return const_cast<tree_node<Value>*>(order_statistic_subtree(node, n));
 }
 
+// return the number of nodes whose keys are less than key
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+size_t count_less_subtree(
+    const tree_node<Value>* root,
+    const Key& key,
+    const KeyComparator& comparator,
+    const KeyExtractor& extractor) noexcept {
+  auto count = size_t{0};
+  while (root != nullptr) {
+    if (comparator(extractor(root->value), key)) {
+      count += (root->left != nullptr ? root->left->size : size_t{0}) + 1;
+      root = root->right;
+    } else {
+      root = root->left;
+    }
+  }
+  return count;
+}
+
+// return the number of nodes whose keys are not greater than key
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+size_t count_not_greater_subtree(
+    const tree_node<Value>* root,
+    const Key& key,
+    const KeyComparator& comparator,
+    const KeyExtractor& extractor) noexcept {
+  auto count = size_t{0};
+  while (root != nullptr) {
+    if (!comparator(key, extractor(root->value))) {
+      count += (root->left != nullptr ? root->left->size : size_t{0}) + 1;
+      root = root->right;
+    } else {
+      root = root->left;
+    }
+  }
+  return count;
+}
+
+// find nodes at sorted ranks `ranks` in the subtree of the node `root` in one
+// traversal: ranks are partitioned at every visited node, so common parts of
+// the search paths are walked once. Ranks not less than the subtree size get
+// null, like `order_statistic_subtree`. The subtree is not rebalanced
+template <typename Value>
+std::vector<const tree_node<Value>*> order_statistics_subtree(
+    const tree_node<Value>* root, const std::vector<size_t>& ranks) {
+  struct task {
+    const tree_node<Value>* node;
+    size_t base;
+    size_t first;
+    size_t last;
+  };
+  auto nodes = std::vector<const tree_node<Value>*>(ranks.size(), nullptr);
+  if (root == nullptr || ranks.empty()) {
+    return nodes;
+  }
+  assert(std::is_sorted(std::begin(ranks), std::end(ranks)));
+  // out of range ranks form a suffix of the sorted ranks and stay null
+  const auto in_range = static_cast<size_t>(
+    std::lower_bound(std::begin(ranks), std::end(ranks), static_cast<size_t>(root->size)) - std::begin(ranks));
+  if (in_range == 0) {
+    return nodes;
+  }
+  auto tasks = std::vector<task>{task{root, 0, 0, in_range}};
+  while (!tasks.empty()) {
+    const auto current = tasks.back();
+    tasks.pop_back();
+    const auto left_size = current.node->left != nullptr ? current.node->left->size : size_t{0};
+    const auto rank = current.base + left_size;
+    const auto first = std::begin(ranks) + current.first;
+    const auto last = std::begin(ranks) + current.last;
+    const auto middle_first = static_cast<size_t>(std::lower_bound(first, last, rank) - std::begin(ranks));
+    const auto middle_last = static_cast<size_t>(std::upper_bound(first, last, rank) - std::begin(ranks));
+    for (auto idx = middle_first; idx < middle_last; ++idx) {
+      nodes[idx] = current.node;
+    }
+    if (current.first < middle_first) {
+      tasks.push_back(task{current.node->left, current.base, current.first, middle_first});
+    }
+    if (middle_last < current.last) {
+      tasks.push_back(task{current.node->right, rank + 1, middle_last, current.last});
+    }
+  }
+  return nodes;
+}
+
+// `k` sorted ranks drawn uniformly with replacement from [first, last)
+template <typename RandomGenerator>
+std::vector<size_t> sample_ranks(size_t first, size_t last, size_t k, RandomGenerator& generator) {
+  auto ranks = std::vector<size_t>{};
+  if (first >= last) {
+    return ranks;
+  }
+  ranks.reserve(k);
+  auto distribution = std::uniform_int_distribution<size_t>{first, last - 1};
+  for (auto idx = size_t{0}; idx < k; ++idx) {
+    ranks.push_back(distribution(generator));
+  }
+  std::sort(std::begin(ranks), std::end(ranks));
+  return ranks;
+}
+
 // return the first node whose key is not less than key
 template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
 tree_node<Value>* lower_bound_subtree(
@@ -352,7 +503,6 @@ tree_node<Value>* copy_subtree(const tree_node<Value>* root) {
   }
   auto node = create_node(root->value);
   assert(node != nullptr);
-  node->size = root->size;
   node->left = copy_subtree(root->left);
   if (node->left != nullptr) {
     node->left->parent = node;
@@ -361,6 +511,8 @@ tree_node<Value>* copy_subtree(const tree_node<Value>* root) {
   if (node->right != nullptr) {
     node->right->parent = node;
   }
+  // the node was created as a leaf, recompute its aggregate with the children
+  update_size(node);
   return node;
 }
 
@@ -382,7 +534,7 @@ tree_node<Value>* merge_subtrees(
   assert(max_lhs->right == nullptr);
   max_lhs->right = rhs;
   rhs->parent = max_lhs;
-  max_lhs->size += rhs->size;
+  update_size(max_lhs);
   return max_lhs;
 }
 
@@ -401,7 +553,7 @@ std::pair<tree_node<Value>*, tree_node<Value>*> split_left_subtree(tree_node<Val
   left->parent = nullptr;
   if (right != nullptr) {
     right->parent = nullptr;
-    left->size -= right->size;
+    update_size(left);
   }
   return std::make_pair(left, right);
 }
@@ -421,7 +573,7 @@ std::pair<tree_node<Value>*, tree_node<Value>*> split_right_subtree(tree_node<Va
   right->parent = nullptr;
   if (left != nullptr) {
     left->parent = nullptr;
-    right->size -= left->size;
+    update_size(right);
   }
   return std::make_pair(left, right);
 }
@@ -555,9 +707,31 @@ tree_node<Value>* insert_tree(
   return node;
 }
 
-// erase node `node` from tree `tree`
+// insert detached node `node` into the tree `tree` and rebalance the tree
+// if the key of `node` is already present returns null, `node` stays detached
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+tree_node<Value>* insert_node_tree(
+    splay_tree_base<Value>& tree,
+    tree_node<Value>* node,
+    const KeyComparator& comparator,
+    const KeyExtractor& extractor) noexcept {
+  if (tree.root == nullptr) {
+    assert(node->parent == nullptr && node->left == nullptr && node->right == nullptr);
+    tree.root = node;
+  } else {
+    node = link_subtree<Key, Value, KeyComparator, KeyExtractor>(
+      tree.root, node, comparator, extractor);
+    if (node != nullptr) {
+      splay_node_tree(tree, node);
+    }
+  }
+  return node;
+}
+
+// unlink node `node` from tree `tree` without destroying it
+// the returned node has no relatives and can be inserted into any tree again
 template <typename Value>
-tree_node<Value>* erase_tree(splay_tree_base<Value>& tree, tree_node<Value>* node) noexcept {
+tree_node<Value>* detach_tree(splay_tree_base<Value>& tree, tree_node<Value>* node) noexcept {
   assert(node->find_root() == tree.root);
   splay_node_tree(tree, node);
   const auto left = node->left;
@@ -568,8 +742,20 @@ tree_node<Value>* erase_tree(splay_tree_base<Value>& tree, tree_node<Value>* nod
   if (node->right != nullptr) {
     node->right->parent = nullptr;
   }
-  destroy_node(node);
+  node->left = nullptr;
+  node->right = nullptr;
+  update_size(node);
   tree.root = merge_subtrees(left, right);
+  return node;
+}
+
+// erase node `node` from tree `tree`
+template <typename Value>
+tree_node<Value>* erase_tree(splay_tree_base<Value>& tree, tree_node<Value>* node) noexcept {
+  assert(node->find_root() == tree.root);
+  splay_node_tree(tree, node);
+  const auto right = node->right;
+  destroy_node(detach_tree(tree, node));
   return right;
 }
 
@@ -626,6 +812,140 @@ void merge_trees(splay_tree_base<Value>& lhs, splay_tree_base<Value>& rhs) noexc
   rhs.root = nullptr;
 }
 
+// move nodes from `rhs` tree into `lhs` tree, keys of the trees may interleave
+// the tree with the smaller minimum is split at the lower bound of the other
+// minimum and the whole run before it is appended to the result, so melding
+// costs O(sum of log of run lengths) amortized instead of O(m log n).
+// nodes of `rhs` with keys already present in `lhs` stay in `rhs`
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+void meld_trees(
+    splay_tree_base<Value>& lhs,
+    splay_tree_base<Value>& rhs,
+    const KeyComparator& comparator,
+    const KeyExtractor& extractor) {
+  auto result = create_tree<Value>();
+  auto duplicates = create_tree<Value>();
+  while (lhs.root != nullptr && rhs.root != nullptr) {
+    // after a split the minimum of the rest is its root
+    auto lhs_min = lhs.root->leftmost_node();
+    splay_node_tree(lhs, lhs_min);
+    auto rhs_min = rhs.root->leftmost_node();
+    splay_node_tree(rhs, rhs_min);
+    if (comparator(extractor(lhs_min->value), extractor(rhs_min->value))) {
+      auto bound = lower_bound_subtree(lhs.root, extractor(rhs_min->value), comparator, extractor);
+      auto rest = split_right_tree(lhs, bound);
+      merge_trees(result, lhs);
+      lhs = rest;
+    } else if (comparator(extractor(rhs_min->value), extractor(lhs_min->value))) {
+      auto bound = lower_bound_subtree(rhs.root, extractor(lhs_min->value), comparator, extractor);
+      auto rest = split_right_tree(rhs, bound);
+      merge_trees(result, rhs);
+      rhs = rest;
+    } else {
+      auto duplicate = create_tree<Value>();
+      duplicate.root = detach_tree(rhs, rhs_min);
+      merge_trees(duplicates, duplicate);
+    }
+  }
+  merge_trees(result, lhs);
+  merge_trees(result, rhs);
+  lhs = result;
+  rhs = duplicates;
+}
+
+// split `tree` into `pivots.size() + 1` trees, the i-th tree gets the nodes
+// with keys in [pivots[i - 1], pivots[i]), pivots must be sorted.
+// every pivot costs one lower bound search and one splay, after call `tree` is empty
+template <typename Key, typename Value, typename KeyComparator, typename KeyExtractor>
+std::vector<splay_tree_base<Value>> split_at_keys_tree(
+    splay_tree_base<Value>& tree,
+    const std::vector<Key>& pivots,
+    const KeyComparator& comparator,
+    const KeyExtractor& extractor) {
+  auto pieces = std::vector<splay_tree_base<Value>>{};
+  pieces.reserve(pivots.size() + 1);
+  for (auto idx = size_t{0}; idx < pivots.size(); ++idx) {
+    assert(idx == 0 || !comparator(pivots[idx], pivots[idx - 1]));
+    auto bound = lower_bound_tree(tree, pivots[idx], comparator, extractor);
+    auto rest = split_right_tree(tree, bound);
+    pieces.push_back(tree);
+    tree = rest;
+  }
+  pieces.push_back(tree);
+  tree = create_tree<Value>();
+  return pieces;
+}
+
+// split `tree` into `positions.size() + 1` trees, the i-th tree gets the nodes
+// at positions [positions[i - 1], positions[i]), positions must be sorted.
+// every position costs one descent and one splay, after call `tree` is empty
+template <typename Value>
+std::vector<splay_tree_base<Value>> split_at_positions_tree(
+    splay_tree_base<Value>& tree, const std::vector<size_t>& positions) {
+  auto pieces = std::vector<splay_tree_base<Value>>{};
+  pieces.reserve(positions.size() + 1);
+  auto offset = size_t{0};
+  for (auto idx = size_t{0}; idx < positions.size(); ++idx) {
+    assert(idx == 0 || positions[idx - 1] <= positions[idx]);
+    auto bound = order_statistic_tree(tree, positions[idx] - offset);
+    auto rest = split_right_tree(tree, bound);
+    offset += get_size_tree(tree);
+    pieces.push_back(tree);
+    tree = rest;
+  }
+  pieces.push_back(tree);
+  tree = create_tree<Value>();
+  return pieces;
+}
+
+// link `nodes[first, last)` into a subtree under `parent` by Mehlhorn's rule:
+// the root is the node whose weight interval contains the middle of the total
+// weight of the range, `prefix[i]` is the weight of `nodes[0, i)`.
+// every subtree weighs at most half of its parent range, so the depth is
+// O(log (total weight / node weight)) and the recursion is shallow
+template <typename Value>
+tree_node<Value>* build_weighted_subtree(
+    const std::vector<tree_node<Value>*>& nodes,
+    const std::vector<uint64_t>& prefix,
+    size_t first,
+    size_t last,
+    tree_node<Value>* parent) noexcept {
+  if (first == last) {
+    return nullptr;
+  }
+  const auto middle = prefix[first] + (prefix[last] - prefix[first]) / 2;
+  const auto bound = std::upper_bound(
+    std::begin(prefix) + first + 1, std::begin(prefix) + last + 1, middle);
+  const auto idx = static_cast<size_t>(bound - std::begin(prefix)) - 1;
+  auto root = nodes[idx];
+  root->parent = parent;
+  root->left = build_weighted_subtree(nodes, prefix, first, idx, root);
+  root->right = build_weighted_subtree(nodes, prefix, idx + 1, last, root);
+  update_size(root);
+  return root;
+}
+
+// reshape `tree` into a nearly optimal search tree for the node weights
+// `weights` given in key order, no nodes are allocated. takes O(n log n)
+template <typename Value>
+void rebuild_weighted_tree(splay_tree_base<Value>& tree, const std::vector<uint64_t>& weights) {
+  assert(weights.size() == get_size_tree(tree));
+  if (tree.root == nullptr) {
+    return;
+  }
+  auto nodes = std::vector<tree_node<Value>*>{};
+  nodes.reserve(weights.size());
+  for (auto node = tree.root->leftmost_node(); node != nullptr; node = node->next_node()) {
+    nodes.push_back(node);
+  }
+  auto prefix = std::vector<uint64_t>(weights.size() + 1, uint64_t{0});
+  for (auto idx = size_t{0}; idx < weights.size(); ++idx) {
+    assert(weights[idx] > 0);
+    prefix[idx + 1] = prefix[idx] + weights[idx];
+  }
+  tree.root = build_weighted_subtree<Value>(nodes, prefix, 0, nodes.size(), nullptr);
+}
+
 // find nth-node (0-based indexing) in the tree with respect to key ordering
 // rebalances the tree
 template <typename Value>
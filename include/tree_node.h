@@ -131,6 +131,16 @@ struct tree_node {
   tree_node<Value>* right;
 };
 
+// Aggregate kept in every node next to `size`. Values that carry information
+// about their whole subtree specialize this template; `update` recomputes it
+// from the node value and its children and is called whenever `size` is
+template <typename Value>
+struct node_augmentation {
+  static void update(tree_node<Value>* node) noexcept {
+    (void)node;
+  }
+};
+
 namespace detail {
 
 template <typename Value>
@@ -140,7 +150,9 @@ void print_node(std::ostream& out, const tree_node<Value>& node) {
 
 template <typename Value>
 tree_node<Value>* create_node(const Value& value) {
-  return new tree_node<Value>(value);
+  auto node = new tree_node<Value>(value);
+  node_augmentation<Value>::update(node);
+  return node;
 }
 
 
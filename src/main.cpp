@@ -2,71 +2,7 @@
 #include <iostream>
 #include <vector>
 
-#include "splay_tree.h"
-
-template <typename T>
-class fast_range_counter {
- private:
-
-  template <typename Key>
-  struct default_key_extractor {
-    const Key& operator () (const Key& t) const {
-      return t;
-    }
-  };
-
-  template <typename Key>
-  struct default_key_comparator {
-    bool operator ()(const Key& lhs, const Key& rhs) const {
-      return lhs < rhs;
-    }
-  };
-
- public:
-  using tree_type = splay::splay_tree<T, T, default_key_comparator<T>, default_key_extractor<T>>;
-
-  fast_range_counter()
-    : tree{}
-  {}
-
-  void add(const T& number) {
-    tree.insert(number);
-  }
-
-  void remove(const T& number) {
-    auto node = tree.find(number);
-    if (node != nullptr) {
-      tree.erase(node);
-    }
-  }
-
-  bool contains(const T& number) {
-    auto node = tree.find(number);
-    return (node != nullptr);
-  }
-
-  size_t count(const T& low, const T& high) {
-    assert(low <= high);
-
-    auto low_node = tree.lower_bound(low);
-    auto middle_right_tree = tree.split_right(low_node);
-    auto& left_tree = tree;
-    auto high_node = middle_right_tree.upper_bound(high);
-    auto right_tree = middle_right_tree.split_right(high_node);
-    auto& middle_tree = middle_right_tree;
-    const auto total = (!middle_tree.empty() ? middle_tree.size() : size_t{0});
-    middle_tree.merge(right_tree);
-    left_tree.merge(middle_tree);
-    return total;
-  }
-
-  const tree_type& get_tree() const {
-    return tree;
-  }
-
- private:
-  tree_type tree;
-};
+#include "fast_range_counter.h"
 
 void run() {
   std::ostream& out = std::cout;
@@ -81,7 +17,7 @@ void run() {
 
   using Value = int64_t;
 
-  auto counter = fast_range_counter<Value>{};
+  auto counter = splay::fast_range_counter<Value>{};
 
   out << "Initial tree: " << counter.get_tree() << '\n';
   while (true)
@@ -1,8 +1,36 @@
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <random>
+#include <set>
+#include <thread>
+#include <stdexcept>
 
 #include "splay_tree.h"
 #include "implicit_splay_tree.h"
+#include "sequence_hash.h"
+#include "subtree_digest.h"
+#include "splay_lru_cache.h"
+#include "interval_map.h"
+#include "interval_tree.h"
+#include "sliding_window_quantiles.h"
+#include "fast_range_counter.h"
+#include "order_book.h"
+#include "reuse_distance_analyzer.h"
+#include "ranking_index.h"
+#include "splay_priority_queue.h"
+#include "splay_timer_queue.h"
+#include "free_space_index.h"
+#include "rectangle_counter.h"
+#include "sliding_window_frequencies.h"
+#include "access_profile.h"
+#include "parallel_traversal.h"
+#include "roaring_set.h"
+#include "lsm_index.h"
+#include "buffered_tree.h"
 
 namespace splay {
 namespace test {
@@ -793,6 +821,92 @@ class splay_tree_tester {
     assert(tree.root() == nullptr);
   }
 
+  void test_meld_interleaved() {
+    auto generator = std::mt19937{59};
+    auto values = std::uniform_int_distribution<int32_t>{0, 300};
+    for (auto round = 0; round < 50; ++round) {
+      auto lhs_tree = tree_type{};
+      auto rhs_tree = tree_type{};
+      auto lhs_keys = std::set<int32_t>{};
+      auto rhs_keys = std::set<int32_t>{};
+      for (auto idx = 0; idx < 100; ++idx) {
+        const auto lhs_value = values(generator);
+        lhs_tree.insert(Value{lhs_value});
+        lhs_keys.insert(lhs_value);
+        const auto rhs_value = values(generator);
+        rhs_tree.insert(Value{rhs_value});
+        rhs_keys.insert(rhs_value);
+      }
+      const auto rhs_first = *rhs_keys.begin();
+      const auto rhs_node = rhs_tree.find(Key{rhs_first});
+      const auto moved = lhs_keys.count(rhs_first) == 0;
+      lhs_tree.meld(rhs_tree);
+      check_tree(lhs_tree);
+      check_tree(rhs_tree);
+      auto duplicates = std::vector<int32_t>{};
+      for (const auto& key : rhs_keys) {
+        if (!lhs_keys.insert(key).second) {
+          duplicates.push_back(key);
+        }
+      }
+      assert(lhs_tree.size() == lhs_keys.size());
+      const tree_node<Value>* node = lhs_tree.order_statistic(0);
+      for (const auto& key : lhs_keys) {
+        assert(node != nullptr && node->value == Value{key});
+        node = node->next_node();
+      }
+      assert(rhs_tree.size() == duplicates.size());
+      for (const auto& key : duplicates) {
+        assert(rhs_tree.find(Key{key}) != nullptr);
+      }
+      // nodes are moved, not copied
+      auto& owner = moved ? lhs_tree : rhs_tree;
+      assert(owner.find(Key{rhs_first}) == rhs_node);
+    }
+  }
+
+  struct counting_comparator {
+    bool operator () (int64_t lhs, int64_t rhs) const noexcept {
+      ++*comparisons;
+      return lhs < rhs;
+    }
+
+    size_t* comparisons;
+  };
+
+  struct counting_extractor {
+    int64_t operator () (int64_t value) const noexcept {
+      return value;
+    }
+  };
+
+  void test_meld_long_runs() {
+    using counting_tree_type = splay_tree<int64_t, int64_t, counting_comparator, counting_extractor>;
+    auto comparisons = size_t{0};
+    auto lhs_tree = counting_tree_type{counting_comparator{&comparisons}, counting_extractor{}};
+    auto rhs_tree = counting_tree_type{counting_comparator{&comparisons}, counting_extractor{}};
+    // 16 alternating runs of 4096 consecutive keys inserted in random order
+    const auto run_length = int64_t{4096};
+    auto keys = std::vector<int64_t>(16 * run_length);
+    std::iota(std::begin(keys), std::end(keys), int64_t{0});
+    std::shuffle(std::begin(keys), std::end(keys), std::mt19937{61});
+    for (const auto& key : keys) {
+      auto& tree = (key / run_length) % 2 == 0 ? lhs_tree : rhs_tree;
+      tree.insert(key);
+    }
+    comparisons = 0;
+    lhs_tree.meld(rhs_tree);
+    // inserting the nodes one by one would take more than 32768 comparisons
+    assert(comparisons < 1000);
+    assert(rhs_tree.empty());
+    assert(lhs_tree.size() == static_cast<size_t>(16 * run_length));
+    auto key = int64_t{0};
+    for (auto node = lhs_tree.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      assert(node->value == key++);
+    }
+    check_tree(lhs_tree);
+  }
+
   void test_all() {
     test_create_and_destroy_empty_tree();
     test_insert_into_empty_tree();
@@ -821,6 +935,8 @@ class splay_tree_tester {
     test_erase_simple();
     test_erase_batch();
     test_clear_tree();
+    test_meld_interleaved();
+    test_meld_long_runs();
   }
 };
 
@@ -1355,6 +1471,2435 @@ class implicit_splay_tree_tester {
   }
 };
 
+class sequence_hash_tester {
+ public:
+  using sequence_type = hashed_sequence<int64_t>;
+
+  static sequence_hash brute_force_hash(const std::vector<int64_t>& values, size_t first, size_t last) {
+    auto result = sequence_hash{uint64_t{0}, uint64_t{0}, last - first};
+    for (auto idx = first; idx < last; ++idx) {
+      const auto hash = detail::hash_element(std::hash<int64_t>{}(values[idx]));
+      result.hash = detail::hash_add(detail::hash_multiply(result.hash, detail::kHashBase), hash);
+    }
+    for (auto idx = last; idx > first; --idx) {
+      const auto hash = detail::hash_element(std::hash<int64_t>{}(values[idx - 1]));
+      result.reversed_hash = detail::hash_add(
+        detail::hash_multiply(result.reversed_hash, detail::kHashBase), hash);
+    }
+    return result;
+  }
+
+  void test_empty_range() {
+    auto sequence = sequence_type{{1, 2, 3}};
+    const auto hash = range_hash(sequence, 1, 1);
+    check_tree(sequence);
+    assert(hash.size == 0);
+    assert(hash.hash == 0);
+    assert(sequence.size() == 3);
+  }
+
+  void test_range_hash_matches_brute_force() {
+    auto values = std::vector<int64_t>{{5, -3, 7, 7, 0, 12, -3, 5, 9, 1, 1, 4}};
+    auto sequence = sequence_type{std::begin(values), std::end(values)};
+    check_tree(sequence);
+    for (auto first = size_t{0}; first <= values.size(); ++first) {
+      for (auto last = first; last <= values.size(); ++last) {
+        const auto hash = range_hash(sequence, first, last);
+        check_tree(sequence);
+        const auto expected = brute_force_hash(values, first, last);
+        assert(hash.size == expected.size);
+        assert(hash.hash == expected.hash);
+        assert(hash.reversed_hash == expected.reversed_hash);
+      }
+    }
+    auto it = sequence.root()->leftmost_node();
+    for (const auto& value : values) {
+      assert(it->value.element == value);
+      it = it->next_node();
+    }
+  }
+
+  void test_equal_ranges() {
+    auto lhs = sequence_type{{1, 2, 3, 4, 5, 6}};
+    auto rhs = sequence_type{{9, 3, 4, 5, 8}};
+    assert(equal_ranges(lhs, 2, rhs, 1, 3));
+    assert(!equal_ranges(lhs, 2, rhs, 1, 4));
+    assert(!equal_ranges(lhs, 0, rhs, 0, 2));
+    assert(equal_ranges(lhs, 1, lhs, 1, 5));
+    check_tree(lhs);
+    check_tree(rhs);
+  }
+
+  void test_is_palindrome() {
+    auto sequence = sequence_type{{1, 2, 3, 2, 1, 7}};
+    assert(is_palindrome(sequence, 0, 5));
+    assert(is_palindrome(sequence, 1, 4));
+    assert(!is_palindrome(sequence, 0, 6));
+    assert(is_palindrome(sequence, 5, 6));
+    check_tree(sequence);
+  }
+
+  void test_hash_after_split_and_merge() {
+    auto values = std::vector<int64_t>{{4, 8, 15, 16, 23, 42}};
+    auto sequence = sequence_type{std::begin(values), std::end(values)};
+    auto right = sequence.split_right(sequence.order_statistic(2));
+    check_tree(sequence);
+    check_tree(right);
+    assert(range_hash(sequence, 0, 2) == brute_force_hash(values, 0, 2));
+    assert(range_hash(right, 0, 4) == brute_force_hash(values, 2, 6));
+    sequence.erase(sequence.order_statistic(1));
+    sequence.merge(right);
+    values.erase(std::begin(values) + 1);
+    check_tree(sequence);
+    assert(range_hash(sequence, 0, values.size()) == brute_force_hash(values, 0, values.size()));
+  }
+
+  void test_copy_keeps_hashes() {
+    auto values = std::vector<int64_t>(200);
+    std::iota(std::begin(values), std::end(values), int64_t{-50});
+    auto sequence = sequence_type{std::begin(values), std::end(values)};
+    sequence.splay(sequence.order_statistic(77));
+    const auto copy = sequence;
+    check_tree(copy);
+    // the copy has the same shape, so every node must carry the same aggregates
+    const tree_node<hashed_value<int64_t>>* lhs = sequence.root()->leftmost_node();
+    const tree_node<hashed_value<int64_t>>* rhs = copy.root()->leftmost_node();
+    for (; lhs != nullptr; lhs = lhs->next_node(), rhs = rhs->next_node()) {
+      assert(rhs != nullptr);
+      assert(lhs->size == rhs->size);
+      assert(lhs->value.hash == rhs->value.hash);
+      assert(lhs->value.reversed_hash == rhs->value.reversed_hash);
+      assert(lhs->value.power == rhs->value.power);
+    }
+    assert(rhs == nullptr);
+    auto assigned = sequence_type{{1, 2}};
+    assigned = copy;
+    assert(range_hash(assigned, 0, values.size()) == brute_force_hash(values, 0, values.size()));
+    assert(range_hash(assigned, 10, 90) == brute_force_hash(values, 10, 90));
+  }
+
+  void test_all() {
+    test_empty_range();
+    test_range_hash_matches_brute_force();
+    test_equal_ranges();
+    test_is_palindrome();
+    test_hash_after_split_and_merge();
+    test_copy_keeps_hashes();
+  }
+};
+
+struct identity_extractor {
+  int64_t operator ()(const int64_t& value) const noexcept {
+    return value;
+  }
+};
+
+struct less_comparator {
+  bool operator ()(const int64_t& lhs, const int64_t& rhs) const noexcept {
+    return lhs < rhs;
+  }
+};
+
+class subtree_digest_tester {
+ public:
+  using tree_type = digested_splay_tree<int64_t, int64_t, less_comparator, identity_extractor>;
+
+  static bool covered(const std::vector<digest_key_range<int64_t>>& ranges, int64_t key) {
+    for (const auto& range : ranges) {
+      if ((!range.has_low || range.low <= key) && (!range.has_high || key < range.high)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void test_digest_range() {
+    auto tree = tree_type{};
+    for (auto key = int64_t{0}; key < 100; ++key) {
+      tree.insert(key);
+    }
+    check_tree(tree);
+    const auto low = int64_t{10};
+    const auto high = int64_t{20};
+    const auto digest = digest_range(tree, &low, &high);
+    check_tree(tree);
+    assert(digest.count == 10);
+    auto other = tree_type{};
+    for (auto key = int64_t{19}; key >= 10; --key) {
+      other.insert(key);
+    }
+    assert(digest == digest_range(other, static_cast<const int64_t*>(nullptr), &high));
+    assert(digest.digest == other.root()->value.digest);
+    assert(tree.size() == 100);
+  }
+
+  void test_identical_replicas() {
+    auto lhs = tree_type{};
+    auto rhs = tree_type{};
+    for (auto key = int64_t{0}; key < 200; ++key) {
+      lhs.insert(key * 7);
+      rhs.insert((199 - key) * 7);
+    }
+    auto source = tree_digest_source<tree_type>{rhs};
+    assert(diff(lhs, source).empty());
+    check_tree(lhs);
+    check_tree(rhs);
+  }
+
+  void test_diff_narrows_down() {
+    auto lhs = tree_type{};
+    auto rhs = tree_type{};
+    for (auto key = int64_t{0}; key < 1000; ++key) {
+      lhs.insert(key);
+      rhs.insert(key);
+    }
+    const auto changed = std::vector<int64_t>{{3, 500, 998}};
+    rhs.erase(rhs.find(3));
+    rhs.erase(rhs.find(500));
+    lhs.erase(lhs.find(998));
+    rhs.insert(2000);
+    auto source = tree_digest_source<tree_type>{rhs};
+    const auto ranges = diff(lhs, source, 4);
+    check_tree(lhs);
+    check_tree(rhs);
+    assert(!ranges.empty());
+    for (const auto& key : changed) {
+      assert(covered(ranges, key));
+    }
+    assert(covered(ranges, 2000));
+    auto covered_keys = size_t{0};
+    for (auto key = int64_t{0}; key < 1000; ++key) {
+      covered_keys += covered(ranges, key) ? 1 : 0;
+    }
+    assert(covered_keys < 40);
+  }
+
+  void test_diff_against_copied_replica() {
+    auto lhs = tree_type{};
+    auto keys = std::vector<int64_t>(60000);
+    std::iota(std::begin(keys), std::end(keys), int64_t{0});
+    std::shuffle(std::begin(keys), std::end(keys), std::mt19937{29});
+    for (const auto key : keys) {
+      lhs.insert(key);
+    }
+    auto replica = lhs;
+    check_tree(replica);
+    assert(replica.root()->value.digest == lhs.root()->value.digest);
+    for (auto key = int64_t{54320}; key < 54332; ++key) {
+      replica.erase(replica.find(key));
+    }
+    auto source = tree_digest_source<tree_type>{replica};
+    const auto ranges = diff(lhs, source, 16);
+    // the erased range may straddle a split point of the diff
+    assert(!ranges.empty() && ranges.size() <= 2);
+    for (auto key = int64_t{54320}; key < 54332; ++key) {
+      assert(covered(ranges, key));
+    }
+    for (const auto& range : ranges) {
+      assert(range.has_low && range.has_high);
+      assert(54320 - 64 <= range.low && range.high <= 54332 + 64);
+    }
+  }
+
+  void test_all() {
+    test_digest_range();
+    test_identical_replicas();
+    test_diff_narrows_down();
+    test_diff_against_copied_replica();
+  }
+};
+
+struct manual_clock {
+  using duration = std::chrono::milliseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<manual_clock>;
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept {
+    return current;
+  }
+
+  static time_point current;
+};
+
+manual_clock::time_point manual_clock::current{};
+
+struct string_weigher {
+  size_t operator () (int64_t, const std::string& value) const noexcept {
+    return value.size();
+  }
+};
+
+class splay_lru_cache_tester {
+ public:
+  using cache_type = splay_lru_cache<int64_t, int64_t>;
+
+  void test_get_and_put() {
+    auto cache = cache_type{3};
+    assert(cache.empty());
+    assert(cache.get(1) == nullptr);
+    assert(cache.put(1, 10));
+    assert(cache.put(2, 20));
+    assert(cache.size() == 2);
+    assert(*cache.get(1) == 10);
+    assert(cache.put(2, 21));
+    assert(*cache.get(2) == 21);
+    assert(cache.size() == 2);
+    assert(cache.statistics().hits == 2);
+    assert(cache.statistics().misses == 1);
+    assert(cache.statistics().evictions == 0);
+  }
+
+  void test_evicts_least_recently_used() {
+    auto cache = cache_type{3};
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    assert(cache.get(1) != nullptr);
+    cache.put(4, 40);
+    assert(cache.size() == 3);
+    assert(!cache.contains(2));
+    assert(cache.contains(1));
+    assert(cache.contains(3));
+    assert(cache.contains(4));
+    cache.put(5, 50);
+    assert(!cache.contains(3));
+    assert(cache.statistics().evictions == 2);
+    assert(cache.erase(1));
+    assert(!cache.erase(1));
+    assert(cache.size() == 2);
+  }
+
+  void test_matches_reference_model() {
+    auto cache = cache_type{16};
+    auto model = std::vector<std::pair<int64_t, int64_t>>{};
+    auto generator = std::mt19937{42};
+    auto keys = std::uniform_int_distribution<int64_t>{0, 40};
+    for (auto step = 0; step < 5000; ++step) {
+      const auto key = keys(generator);
+      auto it = std::find_if(std::begin(model), std::end(model),
+        [key](const std::pair<int64_t, int64_t>& item) { return item.first == key; });
+      if (step % 3 == 0) {
+        cache.put(key, step);
+        if (it != std::end(model)) {
+          model.erase(it);
+        } else if (model.size() == 16) {
+          model.erase(std::begin(model));
+        }
+        model.emplace_back(key, step);
+      } else {
+        const auto value = cache.get(key);
+        if (it == std::end(model)) {
+          assert(value == nullptr);
+        } else {
+          assert(value != nullptr && *value == it->second);
+          const auto item = *it;
+          model.erase(it);
+          model.push_back(item);
+        }
+      }
+      assert(cache.size() == model.size());
+    }
+  }
+
+  void test_capacity_in_bytes() {
+    auto cache = splay_lru_cache<int64_t, std::string, std::less<int64_t>, string_weigher>{10};
+    assert(cache.put(1, "abcd"));
+    assert(cache.put(2, "efgh"));
+    assert(cache.weight() == 8);
+    assert(cache.put(3, "ijk"));
+    assert(cache.weight() == 7);
+    assert(!cache.contains(1));
+    assert(!cache.put(4, "this value is too long"));
+    assert(!cache.contains(4));
+    assert(cache.put(2, "e"));
+    assert(cache.weight() == 4);
+  }
+
+  void test_ttl() {
+    using cache = splay_lru_cache<int64_t, int64_t, std::less<int64_t>, lru_unit_weigher, manual_clock>;
+    auto ttl_cache = cache{4, std::chrono::milliseconds{100}};
+    ttl_cache.put(1, 10);
+    manual_clock::current += std::chrono::milliseconds{60};
+    ttl_cache.put(2, 20);
+    assert(ttl_cache.get(1) != nullptr);
+    manual_clock::current += std::chrono::milliseconds{60};
+    assert(ttl_cache.get(1) == nullptr);
+    assert(ttl_cache.get(2) != nullptr);
+    assert(ttl_cache.size() == 1);
+    assert(ttl_cache.statistics().expirations == 1);
+    assert(ttl_cache.statistics().misses == 1);
+  }
+
+  void test_node_pool_bounds() {
+    auto pool = node_pool<std::string>{2};
+    auto nodes = std::vector<tree_node<std::string>*>{};
+    for (auto idx = 0; idx < 3; ++idx) {
+      nodes.push_back(pool.acquire(std::string(1000, 'a')));
+    }
+    for (const auto node : nodes) {
+      pool.release(node);
+    }
+    // the third node is destroyed, pooled nodes don't keep their values
+    assert(pool.size() == 2);
+    assert(nodes[0]->value.empty() && nodes[0]->value.capacity() < 1000);
+    assert(nodes[1]->value.empty() && nodes[1]->value.capacity() < 1000);
+    const auto reused = pool.acquire("b");
+    assert(reused == nodes[1] && reused->value == "b" && reused->size == 1);
+    assert(pool.size() == 1);
+    detail::destroy_node(reused);
+    // a cache churning through large values keeps evicting without pooling them all
+    auto cache = splay_lru_cache<int64_t, std::string, std::less<int64_t>, string_weigher>{100000};
+    for (auto key = int64_t{0}; key < 10000; ++key) {
+      assert(cache.put(key, std::string(1000, 'x')));
+      if (key % 3 == 0) {
+        assert(cache.erase(key));
+      }
+    }
+    assert(cache.weight() <= 100000);
+    assert(cache.size() <= 100);
+  }
+
+  void test_all() {
+    test_get_and_put();
+    test_evicts_least_recently_used();
+    test_matches_reference_model();
+    test_capacity_in_bytes();
+    test_ttl();
+    test_node_pool_bounds();
+  }
+};
+
+class interval_map_tester {
+ public:
+  using map_type = interval_map<int64_t, int64_t>;
+
+  static const int64_t kDomain = 64;
+  static const int64_t kMissing = -1;
+
+  // check that intervals are disjoint, coalesced and agree with `model`
+  static void check_map(map_type& map, const std::vector<int64_t>& model) {
+    check_tree(map.get_tree());
+    auto expected = std::vector<int64_t>(kDomain, kMissing);
+    auto node = map.get_tree().root() != nullptr ? map.get_tree().root()->leftmost_node() : nullptr;
+    auto prev = static_cast<const tree_node<mapped_interval<int64_t, int64_t>>*>(nullptr);
+    while (node != nullptr) {
+      assert(node->value.start < node->value.end);
+      if (prev != nullptr) {
+        assert(prev->value.end <= node->value.start);
+        assert(prev->value.end < node->value.start || prev->value.value != node->value.value);
+      }
+      for (auto key = node->value.start; key < node->value.end; ++key) {
+        expected[key] = node->value.value;
+      }
+      prev = node;
+      node = node->next_node();
+    }
+    assert(expected == model);
+    for (auto key = int64_t{0}; key < kDomain; ++key) {
+      const auto value = map.find(key);
+      assert(model[key] == kMissing ? value == nullptr : value != nullptr && *value == model[key]);
+    }
+  }
+
+  void test_assign_and_coalesce() {
+    auto map = map_type{};
+    map.assign(0, 10, 1);
+    map.assign(10, 20, 1);
+    assert(map.size() == 1);
+    map.assign(5, 15, 2);
+    assert(map.size() == 3);
+    map.assign(5, 15, 1);
+    assert(map.size() == 1);
+    assert(map.find_interval(7)->start == 0);
+    assert(map.find_interval(7)->end == 20);
+    map.assign(30, 40, 1);
+    map.assign(20, 30, 1);
+    assert(map.size() == 1);
+    assert(map.find(45) == nullptr);
+  }
+
+  void test_erase_splits_interval() {
+    auto map = map_type{};
+    map.assign(0, 100, 7);
+    map.erase(40, 60);
+    assert(map.size() == 2);
+    assert(map.find(39) != nullptr && *map.find(39) == 7);
+    assert(map.find(40) == nullptr);
+    assert(map.find(59) == nullptr);
+    assert(map.find(60) != nullptr && *map.find(60) == 7);
+  }
+
+  void test_for_each_overlap() {
+    auto map = map_type{};
+    map.assign(0, 10, 1);
+    map.assign(12, 20, 2);
+    map.assign(25, 30, 3);
+    map.assign(40, 50, 4);
+    auto values = std::vector<int64_t>{};
+    map.for_each_overlap(5, 26, [&values](const mapped_interval<int64_t, int64_t>& interval) {
+      values.push_back(interval.value);
+    });
+    assert((values == std::vector<int64_t>{{1, 2, 3}}));
+    values.clear();
+    map.for_each_overlap(30, 40, [&values](const mapped_interval<int64_t, int64_t>& interval) {
+      values.push_back(interval.value);
+    });
+    assert(values.empty());
+  }
+
+  void test_matches_reference_model() {
+    auto map = map_type{};
+    auto model = std::vector<int64_t>(kDomain, kMissing);
+    auto generator = std::mt19937{7};
+    auto keys = std::uniform_int_distribution<int64_t>{0, kDomain};
+    auto values = std::uniform_int_distribution<int64_t>{0, 3};
+    for (auto step = 0; step < 2000; ++step) {
+      auto low = keys(generator);
+      auto high = keys(generator);
+      if (high < low) {
+        std::swap(low, high);
+      }
+      if (step % 4 == 0) {
+        map.erase(low, high);
+        std::fill(std::begin(model) + low, std::begin(model) + high, kMissing);
+      } else {
+        const auto value = values(generator);
+        map.assign(low, high, value);
+        std::fill(std::begin(model) + low, std::begin(model) + high, value);
+      }
+      check_map(map, model);
+    }
+  }
+
+  void test_all() {
+    test_assign_and_coalesce();
+    test_erase_splits_interval();
+    test_for_each_overlap();
+    test_matches_reference_model();
+  }
+};
+
+const int64_t interval_map_tester::kDomain;
+const int64_t interval_map_tester::kMissing;
+
+class interval_tree_tester {
+ public:
+  using tree_type = interval_tree<int64_t, int64_t>;
+
+  struct interval {
+    int64_t start;
+    int64_t end;
+    int64_t payload;
+  };
+
+  static std::vector<int64_t> overlaps(tree_type& tree, int64_t low, int64_t high) {
+    auto payloads = std::vector<int64_t>{};
+    tree.for_each_overlap(low, high, [&payloads](const interval_value<int64_t, int64_t>& value) {
+      payloads.push_back(value.payload);
+    });
+    check_tree(tree.get_tree());
+    std::sort(std::begin(payloads), std::end(payloads));
+    return payloads;
+  }
+
+  static std::vector<int64_t> brute_force_overlaps(
+      const std::vector<interval>& intervals, int64_t low, int64_t high) {
+    auto payloads = std::vector<int64_t>{};
+    for (const auto& item : intervals) {
+      if (item.start <= high && low <= item.end) {
+        payloads.push_back(item.payload);
+      }
+    }
+    std::sort(std::begin(payloads), std::end(payloads));
+    return payloads;
+  }
+
+  static void check_max_end(const tree_node<interval_value<int64_t, int64_t>>* node) {
+    if (node == nullptr) {
+      return;
+    }
+    auto max_end = node->value.end;
+    if (node->left != nullptr) {
+      check_max_end(node->left);
+      max_end = std::max(max_end, node->left->value.max_end);
+    }
+    if (node->right != nullptr) {
+      check_max_end(node->right);
+      max_end = std::max(max_end, node->right->value.max_end);
+    }
+    assert(node->value.max_end == max_end);
+  }
+
+  void test_stabbing_query() {
+    auto tree = tree_type{};
+    tree.insert(0, 10, 1);
+    tree.insert(5, 6, 2);
+    tree.insert(5, 6, 3);
+    tree.insert(8, 20, 4);
+    tree.insert(30, 40, 5);
+    auto payloads = std::vector<int64_t>{};
+    tree.for_each_containing(6, [&payloads](const interval_value<int64_t, int64_t>& value) {
+      payloads.push_back(value.payload);
+    });
+    assert((payloads == std::vector<int64_t>{{1, 2, 3}}));
+    assert(overlaps(tree, 21, 29).empty());
+    assert((overlaps(tree, 20, 30) == std::vector<int64_t>{{4, 5}}));
+    check_max_end(tree.get_tree().root());
+  }
+
+  void test_matches_brute_force() {
+    auto tree = tree_type{};
+    auto intervals = std::vector<interval>{};
+    auto nodes = std::vector<tree_type::node_type*>{};
+    auto generator = std::mt19937{13};
+    auto points = std::uniform_int_distribution<int64_t>{0, 1000};
+    auto lengths = std::uniform_int_distribution<int64_t>{0, 50};
+    for (auto step = int64_t{0}; step < 3000; ++step) {
+      if (step % 5 == 4 && !intervals.empty()) {
+        const auto idx = static_cast<size_t>(points(generator)) % intervals.size();
+        tree.erase(nodes[idx]);
+        intervals.erase(std::begin(intervals) + idx);
+        nodes.erase(std::begin(nodes) + idx);
+      } else {
+        const auto start = points(generator);
+        const auto end = start + lengths(generator);
+        intervals.push_back(interval{start, end, step});
+        nodes.push_back(tree.insert(start, end, step));
+      }
+      check_max_end(tree.get_tree().root());
+      const auto low = points(generator);
+      const auto high = low + lengths(generator);
+      assert(overlaps(tree, low, high) == brute_force_overlaps(intervals, low, high));
+      check_max_end(tree.get_tree().root());
+    }
+  }
+
+  void test_copy() {
+    auto tree = tree_type{};
+    auto intervals = std::vector<interval>{};
+    auto generator = std::mt19937{17};
+    auto points = std::uniform_int_distribution<int64_t>{0, 10000};
+    for (auto step = int64_t{0}; step < 500; ++step) {
+      const auto start = points(generator);
+      const auto end = start + step % 7;
+      intervals.push_back(interval{start, end, step});
+      tree.insert(start, end, step);
+    }
+    // a single long interval deep in the tree
+    intervals.push_back(interval{1, 9000, 500});
+    tree.insert(1, 9000, 500);
+    auto copy = tree;
+    check_max_end(copy.get_tree().root());
+    assert((overlaps(copy, 8500, 8500) == brute_force_overlaps(intervals, 8500, 8500)));
+    auto assigned = tree_type{};
+    assigned.insert(0, 1, 0);
+    assigned = tree;
+    check_max_end(assigned.get_tree().root());
+    for (auto point = int64_t{0}; point < 10000; point += 97) {
+      assert(overlaps(assigned, point, point) == brute_force_overlaps(intervals, point, point));
+      assert(overlaps(copy, point, point + 50) == brute_force_overlaps(intervals, point, point + 50));
+    }
+  }
+
+  void test_all() {
+    test_stabbing_query();
+    test_matches_brute_force();
+    test_copy();
+  }
+};
+
+class sliding_window_quantiles_tester {
+ public:
+  using window_type = sliding_window_quantiles<int64_t>;
+
+  static int64_t brute_force_quantile(std::vector<int64_t> values, double q) {
+    std::sort(std::begin(values), std::end(values));
+    return values[static_cast<size_t>(q * static_cast<double>(values.size() - 1))];
+  }
+
+  void test_count_window() {
+    auto window = window_type{5};
+    auto values = std::vector<int64_t>{};
+    auto generator = std::mt19937{3};
+    auto samples = std::uniform_int_distribution<int64_t>{0, 20};
+    for (auto step = 0; step < 1000; ++step) {
+      const auto value = samples(generator);
+      window.push(value);
+      values.push_back(value);
+      if (values.size() > 5) {
+        values.erase(std::begin(values));
+      }
+      assert(window.size() == values.size());
+      for (const auto q : {0.0, 0.25, 0.5, 0.95, 0.99, 1.0}) {
+        assert(window.quantile(q) == brute_force_quantile(values, q));
+      }
+    }
+  }
+
+  void test_time_window() {
+    auto window = window_type{0, 10};
+    window.push(5, 0);
+    window.push(1, 3);
+    window.push(9, 7);
+    assert(window.size() == 3);
+    assert(window.median() == 5);
+    window.push(7, 10);
+    assert(window.size() == 3);
+    assert(window.min() == 1);
+    window.expire(14);
+    assert(window.size() == 2);
+    assert(window.min() == 7);
+    assert(window.max() == 9);
+    window.expire(100);
+    assert(window.empty());
+  }
+
+  void test_duplicates() {
+    auto window = window_type{4};
+    for (auto step = 0; step < 10; ++step) {
+      window.push(step % 2);
+    }
+    assert(window.size() == 4);
+    assert(window.min() == 0);
+    assert(window.max() == 1);
+    assert(window.quantile(0.3) == 0);
+    assert(window.quantile(0.7) == 1);
+  }
+
+  void test_all() {
+    test_count_window();
+    test_time_window();
+    test_duplicates();
+  }
+};
+
+class expiring_range_counter_tester {
+ public:
+  using counter_type = expiring_range_counter<int64_t>;
+
+  void test_count_skips_expired() {
+    auto counter = counter_type{10};
+    counter.add(1, 0);
+    counter.add(5, 2);
+    counter.add(9, 4);
+    assert(counter.count(0, 10, 5) == 3);
+    assert(counter.count(0, 10, 10) == 2);
+    assert(!counter.contains(1, 10));
+    assert(counter.count(4, 9, 11) == 2);
+    assert(counter.count(4, 9, 12) == 1);
+    assert(counter.count(0, 100, 14) == 0);
+    assert(counter.size() == 0);
+  }
+
+  void test_refresh_and_remove() {
+    auto counter = counter_type{10};
+    counter.add(1, 0);
+    counter.add(2, 0);
+    counter.add(1, 8);
+    assert(counter.count(0, 5, 12) == 1);
+    assert(counter.contains(1, 12));
+    counter.remove(1);
+    assert(!counter.contains(1, 12));
+    assert(counter.size() == 0);
+  }
+
+  void test_matches_brute_force() {
+    const auto ttl = int64_t{50};
+    auto counter = counter_type{ttl};
+    auto last_added = std::vector<int64_t>(100, std::numeric_limits<int64_t>::min());
+    auto generator = std::mt19937{17};
+    auto numbers = std::uniform_int_distribution<int64_t>{0, 99};
+    auto now = int64_t{0};
+    for (auto step = 0; step < 3000; ++step) {
+      now += step % 3;
+      const auto number = numbers(generator);
+      if (step % 7 == 0) {
+        counter.remove(number);
+        last_added[number] = std::numeric_limits<int64_t>::min();
+      } else {
+        counter.add(number, now);
+        last_added[number] = now;
+      }
+      auto low = numbers(generator);
+      auto high = numbers(generator);
+      if (high < low) {
+        std::swap(low, high);
+      }
+      auto expected = size_t{0};
+      for (auto idx = low; idx <= high; ++idx) {
+        expected += last_added[idx] > now - ttl ? 1 : 0;
+      }
+      assert(counter.count(low, high, now) == expected);
+      check_tree(counter.get_tree());
+    }
+  }
+
+  void test_all() {
+    test_count_skips_expired();
+    test_refresh_and_remove();
+    test_matches_brute_force();
+  }
+};
+
+class order_book_tester {
+ public:
+  void test_resting_orders_and_levels() {
+    auto book = order_book{};
+    book.add(1, order_side::kBuy, 99, 10);
+    book.add(2, order_side::kBuy, 100, 5);
+    book.add(3, order_side::kBuy, 99, 7);
+    book.add(4, order_side::kSell, 102, 3);
+    book.add(5, order_side::kSell, 101, 4);
+    assert(book.size() == 5);
+    assert(book.depth(order_side::kBuy) == 2);
+    assert(book.best(order_side::kBuy)->price == 100);
+    assert(book.best(order_side::kSell)->price == 101);
+    assert(book.level(order_side::kBuy, 1)->price == 99);
+    assert(book.level(order_side::kBuy, 1)->quantity == 17);
+    assert(book.level(order_side::kBuy, 1)->order_count == 2);
+    assert(book.level(order_side::kSell, 1)->price == 102);
+    assert(book.level(order_side::kSell, 2) == nullptr);
+    assert(book.depth_quantity(order_side::kBuy, 2) == 22);
+    assert(book.depth_quantity(order_side::kSell, 5) == 7);
+  }
+
+  void test_matching_in_price_time_priority() {
+    auto book = order_book{};
+    book.add(1, order_side::kSell, 101, 5);
+    book.add(2, order_side::kSell, 100, 5);
+    book.add(3, order_side::kSell, 100, 5);
+    auto trades = std::vector<book_trade>{};
+    auto resting = book.add(4, order_side::kBuy, 101, 12, [&trades](const book_trade& trade) {
+      trades.push_back(trade);
+    });
+    assert(resting == nullptr);
+    assert(trades.size() == 3);
+    assert(trades[0].maker_id == 2 && trades[0].price == 100 && trades[0].quantity == 5);
+    assert(trades[1].maker_id == 3 && trades[1].price == 100 && trades[1].quantity == 5);
+    assert(trades[2].maker_id == 1 && trades[2].price == 101 && trades[2].quantity == 2);
+    assert(book.size() == 1);
+    assert(book.best(order_side::kSell)->quantity == 3);
+    resting = book.add(5, order_side::kBuy, 102, 10);
+    assert(resting != nullptr && resting->quantity == 7);
+    assert(book.best(order_side::kSell) == nullptr);
+    assert(book.best(order_side::kBuy)->price == 102);
+    assert(book.traded_volume() == 15);
+  }
+
+  void test_cancel_reduce_and_replace() {
+    auto book = order_book{};
+    auto first = book.add(1, order_side::kBuy, 100, 10);
+    book.add(2, order_side::kBuy, 100, 10);
+    book.add(3, order_side::kBuy, 98, 10);
+    book.cancel(first);
+    assert(book.find(1) == nullptr);
+    assert(book.best(order_side::kBuy)->quantity == 10);
+    assert(book.reduce(2, 4));
+    assert(book.best(order_side::kBuy)->quantity == 6);
+    assert(book.execute(2, 6));
+    assert(book.depth(order_side::kBuy) == 1);
+    assert(book.best(order_side::kBuy)->price == 98);
+    assert(book.replace(3, 4, 99, 1) != nullptr);
+    assert(book.find(3) == nullptr);
+    assert(book.best(order_side::kBuy)->price == 99);
+    assert(!book.cancel(42));
+    assert(book.cancel(4));
+    assert(book.size() == 0);
+    assert(book.depth(order_side::kBuy) == 0);
+  }
+
+  void test_all() {
+    test_resting_orders_and_levels();
+    test_matching_in_price_time_priority();
+    test_cancel_reduce_and_replace();
+  }
+};
+
+class reuse_distance_analyzer_tester {
+ public:
+  using analyzer_type = reuse_distance_analyzer<int64_t>;
+
+  void test_simple_trace() {
+    auto analyzer = analyzer_type{8};
+    const auto trace = std::vector<int64_t>{{1, 2, 3, 1, 1, 3, 2}};
+    auto distances = std::vector<uint64_t>{};
+    for (const auto& address : trace) {
+      distances.push_back(analyzer.access(address));
+    }
+    const auto cold = analyzer_type::kColdMiss;
+    assert((distances == std::vector<uint64_t>{{cold, cold, cold, 2, 0, 1, 2}}));
+    assert(analyzer.distinct_addresses() == 3);
+    assert(analyzer.distance_histogram()[2] == 2);
+    assert(analyzer.miss_ratio(0) == 1.0);
+    assert(analyzer.miss_ratio(1) == 6.0 / 7.0);
+    assert(analyzer.miss_ratio(3) == 3.0 / 7.0);
+    const auto curve = analyzer.miss_ratio_curve();
+    assert(curve[2] == analyzer.miss_ratio(2));
+    assert(curve[3] == analyzer.miss_ratio(3));
+  }
+
+  void test_matches_lru_stack() {
+    auto analyzer = analyzer_type{16};
+    auto stack = std::vector<int64_t>{};
+    auto generator = std::mt19937{23};
+    auto addresses = std::uniform_int_distribution<int64_t>{0, 40};
+    for (auto step = 0; step < 5000; ++step) {
+      const auto address = addresses(generator);
+      auto it = std::find(std::begin(stack), std::end(stack), address);
+      auto expected = analyzer_type::kColdMiss;
+      if (it != std::end(stack)) {
+        expected = static_cast<uint64_t>(it - std::begin(stack));
+        stack.erase(it);
+      }
+      stack.insert(std::begin(stack), address);
+      assert(analyzer.access(address) == expected);
+    }
+    auto total = analyzer.overflow_count() + analyzer.distinct_addresses();
+    for (const auto& count : analyzer.distance_histogram()) {
+      total += count;
+    }
+    assert(total == analyzer.accesses());
+  }
+
+  void test_all() {
+    test_simple_trace();
+    test_matches_lru_stack();
+  }
+};
+
+class ranking_index_tester {
+ public:
+  using index_type = ranking_index<int64_t, int64_t>;
+
+  static std::vector<std::pair<int64_t, int64_t>> brute_force_ranking(
+      const std::vector<int64_t>& scores) {
+    auto ranking = std::vector<std::pair<int64_t, int64_t>>{};
+    for (auto id = int64_t{0}; id < static_cast<int64_t>(scores.size()); ++id) {
+      if (scores[id] >= 0) {
+        ranking.emplace_back(-scores[id], id);
+      }
+    }
+    std::sort(std::begin(ranking), std::end(ranking));
+    return ranking;
+  }
+
+  void test_rank_and_pages() {
+    auto index = index_type{};
+    index.update_score(1, 50);
+    index.update_score(2, 70);
+    index.update_score(3, 50);
+    index.update_score(4, 10);
+    assert(index.rank_of(2) == 0);
+    assert(index.rank_of(1) == 1);
+    assert(index.rank_of(3) == 2);
+    assert(index.rank_of(4) == 3);
+    assert(index.rank_of(5) == 4);
+    index.update_score(4, 100);
+    assert(index.rank_of(4) == 0);
+    assert(*index.score_of(4) == 100);
+    const auto top = index.top_k(2);
+    assert(top.size() == 2 && top[0].id == 4 && top[1].id == 2);
+    const auto page = index.page(2, 10);
+    assert(page.size() == 2 && page[0].id == 1 && page[1].id == 3);
+    assert(index.at(1)->id == 2);
+    assert(index.count_scores(50, 70) == 3);
+    assert(index.count_scores(51, 69) == 0);
+    assert(index.erase(2));
+    assert(!index.erase(2));
+    assert(index.count_scores(50, 70) == 2);
+  }
+
+  void test_matches_brute_force() {
+    auto index = index_type{};
+    auto scores = std::vector<int64_t>(50, -1);
+    auto generator = std::mt19937{31};
+    auto ids = std::uniform_int_distribution<int64_t>{0, 49};
+    auto values = std::uniform_int_distribution<int64_t>{0, 30};
+    for (auto step = 0; step < 2000; ++step) {
+      const auto id = ids(generator);
+      if (step % 9 == 0) {
+        index.erase(id);
+        scores[id] = -1;
+      } else {
+        const auto score = values(generator);
+        index.update_score(id, score);
+        scores[id] = score;
+      }
+      check_tree(index.get_tree());
+      const auto ranking = brute_force_ranking(scores);
+      assert(index.size() == ranking.size());
+      for (auto rank = size_t{0}; rank < ranking.size(); rank += 7) {
+        assert(index.rank_of(ranking[rank].second) == rank);
+      }
+      auto low = values(generator);
+      auto high = values(generator);
+      if (high < low) {
+        std::swap(low, high);
+      }
+      const auto expected = std::count_if(std::begin(ranking), std::end(ranking),
+        [low, high](const std::pair<int64_t, int64_t>& item) {
+          return -item.first >= low && -item.first <= high;
+        });
+      assert(index.count_scores(low, high) == static_cast<size_t>(expected));
+    }
+  }
+
+  // ids without a default constructor
+  struct player_id {
+    explicit player_id(int64_t number)
+      : number{number}
+    {}
+
+    bool operator == (const player_id& other) const noexcept {
+      return number == other.number;
+    }
+
+    bool operator < (const player_id& other) const noexcept {
+      return number < other.number;
+    }
+
+    int64_t number;
+  };
+
+  struct player_id_hash {
+    size_t operator () (const player_id& id) const noexcept {
+      return std::hash<int64_t>{}(id.number);
+    }
+  };
+
+  void test_update_relinks_node() {
+    auto index = ranking_index<player_id, int64_t, player_id_hash>{};
+    for (auto number = int64_t{0}; number < 20; ++number) {
+      index.update_score(player_id{number}, number * 10);
+    }
+    const auto node = index.get_tree().root()->leftmost_node();
+    assert(node->value.id.number == 19);
+    index.update_score(player_id{19}, -5);
+    check_tree(index.get_tree());
+    assert(index.rank_of(player_id{19}) == 19);
+    assert(index.get_tree().root() == node);
+    assert(index.count_scores(0, 50) == 6);
+    assert(index.count_scores(-5, -5) == 1);
+    assert(index.at(0)->id.number == 18);
+  }
+
+  void test_all() {
+    test_rank_and_pages();
+    test_matches_brute_force();
+    test_update_relinks_node();
+  }
+};
+
+class splay_priority_queue_tester {
+ public:
+  using queue_type = splay_priority_queue<int64_t>;
+
+  void test_pop_both_ends() {
+    auto queue = queue_type{};
+    for (const auto value : {5, 1, 9, 3, 7, 3}) {
+      queue.push(value);
+    }
+    assert(queue.size() == 6);
+    assert(queue.top_min() == 1);
+    assert(queue.top_max() == 9);
+    assert(queue.pop_min() == 1);
+    assert(queue.pop_max() == 9);
+    assert(queue.pop_min() == 3);
+    assert(queue.pop_min() == 3);
+    assert(queue.pop_max() == 7);
+    assert(queue.pop_max() == 5);
+    assert(queue.empty());
+  }
+
+  void test_update_and_erase_by_handle() {
+    auto queue = queue_type{};
+    auto first = queue.push(10);
+    auto second = queue.push(20);
+    auto third = queue.push(30);
+    queue.decrease_key(third, 5);
+    assert(queue.top_min() == 5);
+    assert(queue.get(third) == 5);
+    queue.increase_key(first, 40);
+    assert(queue.top_max() == 40);
+    queue.erase(second);
+    assert(queue.size() == 2);
+    assert(queue.pop_min() == 5);
+    assert(queue.pop_min() == 40);
+  }
+
+  void test_meld() {
+    auto lhs = queue_type{};
+    auto rhs = queue_type{};
+    lhs.push(1);
+    lhs.push(2);
+    auto handle = rhs.push(10);
+    rhs.push(11);
+    lhs.meld(rhs);
+    assert(rhs.empty());
+    assert(lhs.size() == 4);
+    assert(lhs.get(handle) == 10);
+    lhs.decrease_key(handle, 0);
+    assert(lhs.top_min() == 0);
+
+    auto interleaved = queue_type{};
+    auto values = std::vector<int64_t>{};
+    for (auto value = int64_t{-5}; value < 20; value += 3) {
+      interleaved.push(value);
+      values.push_back(value);
+    }
+    for (auto value = int64_t{3}; value < 10; ++value) {
+      values.push_back(value);
+    }
+    for (auto value = int64_t{4}; value < 12; ++value) {
+      values.push_back(value);
+    }
+    values.push_back(0);
+    values.push_back(1);
+    values.push_back(2);
+    values.push_back(11);
+    interleaved.meld(lhs);
+    assert(lhs.empty());
+    for (auto value = int64_t{3}; value < 10; ++value) {
+      interleaved.push(value);
+    }
+    for (auto value = int64_t{4}; value < 12; ++value) {
+      interleaved.push(value);
+    }
+    std::sort(std::begin(values), std::end(values));
+    assert(interleaved.size() == values.size());
+    for (const auto& value : values) {
+      assert(interleaved.pop_min() == value);
+    }
+  }
+
+  void test_matches_sorted_model() {
+    auto queue = queue_type{};
+    auto model = std::multiset<int64_t>{};
+    auto generator = std::mt19937{37};
+    auto values = std::uniform_int_distribution<int64_t>{0, 100};
+    for (auto step = 0; step < 5000; ++step) {
+      const auto action = values(generator);
+      if (action < 50 || model.empty()) {
+        const auto value = values(generator);
+        queue.push(value);
+        model.insert(value);
+      } else if (action < 75) {
+        assert(queue.pop_min() == *model.begin());
+        model.erase(model.begin());
+      } else {
+        assert(queue.pop_max() == *model.rbegin());
+        model.erase(std::prev(model.end()));
+      }
+      assert(queue.size() == model.size());
+    }
+  }
+
+  void test_all() {
+    test_pop_both_ends();
+    test_update_and_erase_by_handle();
+    test_meld();
+    test_matches_sorted_model();
+  }
+};
+
+class splay_timer_queue_tester {
+ public:
+  using queue_type = splay_timer_queue<int64_t, int64_t>;
+
+  static std::vector<int64_t> payloads(const queue_type::batch_type& batch) {
+    auto result = std::vector<int64_t>{};
+    batch.for_each([&result](const scheduled_timer<int64_t, int64_t>& timer) {
+      result.push_back(timer.payload);
+    });
+    return result;
+  }
+
+  void test_expire_until() {
+    auto queue = queue_type{};
+    queue.schedule(30, 3);
+    queue.schedule(10, 1);
+    queue.schedule(20, 2);
+    queue.schedule(10, 4);
+    assert(queue.next()->deadline == 10);
+    assert(queue.expire_until(5).empty());
+    auto batch = queue.expire_until(20);
+    assert((payloads(batch) == std::vector<int64_t>{{1, 4, 2}}));
+    assert(queue.size() == 1);
+    assert(queue.next()->payload == 3);
+    assert(queue.expire_until(100).size() == 1);
+    assert(queue.empty());
+    assert(queue.next() == nullptr);
+  }
+
+  void test_cancel_and_reschedule() {
+    auto queue = queue_type{};
+    auto first = queue.schedule(10, 1);
+    auto second = queue.schedule(20, 2);
+    auto third = queue.schedule(30, 3);
+    queue.cancel(second);
+    queue.reschedule(first, 40);
+    queue.reschedule(third, 5);
+    auto batch = queue.expire_until(35);
+    assert((payloads(batch) == std::vector<int64_t>{{3}}));
+    queue.reschedule(first, 35);
+    batch = queue.expire_until(35);
+    assert((payloads(batch) == std::vector<int64_t>{{1}}));
+    assert(queue.empty());
+  }
+
+  void test_matches_brute_force() {
+    auto queue = queue_type{};
+    auto pending = std::vector<std::pair<int64_t, queue_type::handle_type>>{};
+    auto generator = std::mt19937{41};
+    auto delays = std::uniform_int_distribution<int64_t>{0, 100};
+    auto now = int64_t{0};
+    for (auto step = int64_t{0}; step < 3000; ++step) {
+      const auto roll = delays(generator);
+      if (roll < 60) {
+        const auto deadline = now + delays(generator);
+        pending.emplace_back(deadline, queue.schedule(deadline, step));
+      } else if (roll < 75 && !pending.empty()) {
+        const auto idx = static_cast<size_t>(delays(generator)) % pending.size();
+        queue.cancel(pending[idx].second);
+        pending.erase(std::begin(pending) + idx);
+      } else if (roll < 85 && !pending.empty()) {
+        const auto idx = static_cast<size_t>(delays(generator)) % pending.size();
+        pending[idx].first = now + delays(generator);
+        queue.reschedule(pending[idx].second, pending[idx].first);
+      } else {
+        now += delays(generator) / 4;
+        auto batch = queue.expire_until(now);
+        auto expected = size_t{0};
+        for (auto it = std::begin(pending); it != std::end(pending);) {
+          if (it->first <= now) {
+            ++expected;
+            it = pending.erase(it);
+          } else {
+            ++it;
+          }
+        }
+        assert(batch.size() == expected);
+        auto last = std::numeric_limits<int64_t>::min();
+        batch.for_each([&last, now](const scheduled_timer<int64_t, int64_t>& timer) {
+          assert(last <= timer.deadline && timer.deadline <= now);
+          last = timer.deadline;
+        });
+      }
+      assert(queue.size() == pending.size());
+    }
+  }
+
+  void test_all() {
+    test_expire_until();
+    test_cancel_and_reschedule();
+    test_matches_brute_force();
+  }
+};
+
+class free_space_index_tester {
+ public:
+  static std::vector<std::pair<uint64_t, uint64_t>> extents(const free_space_index& index) {
+    auto result = std::vector<std::pair<uint64_t, uint64_t>>{};
+    index.for_each([&result](const free_extent& extent) {
+      result.emplace_back(extent.offset, extent.length);
+    });
+    return result;
+  }
+
+  void test_best_fit() {
+    auto index = free_space_index{};
+    index.release(0, 100);
+    index.release(200, 10);
+    index.release(300, 30);
+    assert(index.allocate(20) == 300);
+    assert(index.allocate(10) == 200);
+    assert(index.allocate(10) == 320);
+    assert(index.allocate(200) == free_space_index::kNoSpace);
+    assert(index.allocate(100) == 0);
+    assert(index.free_bytes() == 0);
+    assert(index.extent_count() == 0);
+  }
+
+  void test_coalescing() {
+    auto index = free_space_index{0, 100};
+    const auto first = index.allocate(10);
+    const auto second = index.allocate(10);
+    const auto third = index.allocate(10);
+    assert(first == 0 && second == 10 && third == 20);
+    assert(index.extent_count() == 1);
+    index.release(first, 10);
+    index.release(third, 10);
+    assert((extents(index) == std::vector<std::pair<uint64_t, uint64_t>>{{{0, 10}, {20, 80}}}));
+    index.release(second, 10);
+    assert((extents(index) == std::vector<std::pair<uint64_t, uint64_t>>{{{0, 100}}}));
+    assert(index.largest_extent() == 100);
+  }
+
+  void test_matches_bitmap() {
+    const auto capacity = size_t{512};
+    auto index = free_space_index{0, capacity};
+    auto used = std::vector<bool>(capacity, false);
+    auto allocations = std::vector<std::pair<uint64_t, uint64_t>>{};
+    auto generator = std::mt19937{43};
+    auto lengths = std::uniform_int_distribution<uint64_t>{1, 24};
+    for (auto step = 0; step < 4000; ++step) {
+      if (lengths(generator) % 2 == 0 || allocations.empty()) {
+        const auto length = lengths(generator);
+        const auto offset = index.allocate(length);
+        if (offset == free_space_index::kNoSpace) {
+          assert(index.largest_extent() < length);
+          continue;
+        }
+        for (auto idx = offset; idx < offset + length; ++idx) {
+          assert(!used[idx]);
+          used[idx] = true;
+        }
+        allocations.emplace_back(offset, length);
+      } else {
+        const auto idx = static_cast<size_t>(lengths(generator)) % allocations.size();
+        const auto allocation = allocations[idx];
+        allocations.erase(std::begin(allocations) + idx);
+        index.release(allocation.first, allocation.second);
+        for (auto pos = allocation.first; pos < allocation.first + allocation.second; ++pos) {
+          used[pos] = false;
+        }
+      }
+      check_tree(index.get_offset_tree());
+      check_tree(index.get_length_tree());
+      const auto free_extents = extents(index);
+      auto previous_end = std::numeric_limits<uint64_t>::max();
+      auto free_bytes = uint64_t{0};
+      for (const auto& extent : free_extents) {
+        assert(extent.first != previous_end);
+        for (auto pos = extent.first; pos < extent.first + extent.second; ++pos) {
+          assert(!used[pos]);
+        }
+        previous_end = extent.first + extent.second;
+        free_bytes += extent.second;
+      }
+      assert(free_bytes == index.free_bytes());
+      assert(free_bytes == static_cast<uint64_t>(std::count(std::begin(used), std::end(used), false)));
+    }
+  }
+
+  void test_all() {
+    test_best_fit();
+    test_coalescing();
+    test_matches_bitmap();
+  }
+};
+
+class rectangle_counter_tester {
+ public:
+  using point = plane_point<int32_t>;
+  using rectangle = plane_rectangle<int32_t>;
+
+  static std::vector<size_t> count_nested(
+      const std::vector<point>& points, const std::vector<rectangle>& rectangles) {
+    auto counts = std::vector<size_t>(rectangles.size(), size_t{0});
+    for (auto idx = size_t{0}; idx < rectangles.size(); ++idx) {
+      const auto& area = rectangles[idx];
+      for (const auto& item : points) {
+        if (area.x_low <= item.x && item.x <= area.x_high &&
+            area.y_low <= item.y && item.y <= area.y_high) {
+          ++counts[idx];
+        }
+      }
+    }
+    return counts;
+  }
+
+  void test_small() {
+    const auto points = std::vector<point>{{1, 1}, {2, 2}, {2, 2}, {3, 5}, {5, 3}, {4, 4}};
+    const auto rectangles = std::vector<rectangle>{
+      {1, 5, 1, 5}, {2, 2, 2, 2}, {2, 4, 2, 4}, {3, 5, 3, 3}, {4, 1, 0, 10}, {0, 10, 6, 10}};
+    const auto expected = std::vector<size_t>{6, 2, 3, 1, 0, 0};
+    assert(count_rectangles(points, rectangles) == expected);
+    assert(count_rectangles_parallel(points, rectangles, 3) == expected);
+    assert(count_rectangles_parallel(points, rectangles, 100) == expected);
+    assert(count_rectangles(std::vector<point>{}, rectangles) == std::vector<size_t>(6, 0));
+    assert(count_rectangles_parallel(std::vector<point>{}, rectangles) == std::vector<size_t>(6, 0));
+  }
+
+  void test_dominance() {
+    const auto points = std::vector<point>{{1, 1}, {2, 3}, {3, 2}, {3, 3}};
+    const auto corners = std::vector<point>{{0, 0}, {1, 1}, {3, 2}, {2, 3}, {3, 3}};
+    assert((count_dominated(points, corners) == std::vector<size_t>{0, 1, 2, 2, 4}));
+  }
+
+  void test_matches_nested_loop() {
+    auto generator = std::mt19937{47};
+    auto coordinate = std::uniform_int_distribution<int32_t>{-20, 20};
+    for (auto round = 0; round < 20; ++round) {
+      auto points = std::vector<point>{};
+      for (auto idx = 0; idx < 200; ++idx) {
+        points.push_back(point{coordinate(generator), coordinate(generator)});
+      }
+      auto rectangles = std::vector<rectangle>{};
+      for (auto idx = 0; idx < 200; ++idx) {
+        rectangles.push_back(rectangle{
+          coordinate(generator), coordinate(generator), coordinate(generator), coordinate(generator)});
+      }
+      const auto expected = count_nested(points, rectangles);
+      assert(count_rectangles(points, rectangles) == expected);
+      assert(count_rectangles_parallel(points, rectangles, 1 + round % 5) == expected);
+    }
+  }
+
+  void test_all() {
+    test_small();
+    test_dominance();
+    test_matches_nested_loop();
+  }
+};
+
+class sliding_window_frequencies_tester {
+ public:
+  using frequencies_type = sliding_window_frequencies<int32_t>;
+
+  static std::vector<std::pair<int32_t, size_t>> pairs(const std::vector<key_frequency<int32_t>>& items) {
+    auto result = std::vector<std::pair<int32_t, size_t>>{};
+    for (const auto& item : items) {
+      result.emplace_back(item.key, item.count);
+    }
+    return result;
+  }
+
+  void test_count_window() {
+    auto window = frequencies_type{5};
+    for (const auto key : {1, 2, 1, 3, 1}) {
+      window.push(key);
+    }
+    assert(window.size() == 5);
+    assert(window.distinct_count() == 3);
+    assert(window.frequency(1) == 3);
+    assert((pairs(window.top_k(2)) == std::vector<std::pair<int32_t, size_t>>{{1, 3}, {2, 1}}));
+    window.push(4);
+    window.push(4);
+    window.push(5);
+    // window is 3 1 4 4 5
+    assert(window.distinct_count() == 4);
+    assert(window.frequency(2) == 0);
+    assert((pairs(window.top_k(10)) ==
+      std::vector<std::pair<int32_t, size_t>>{{4, 2}, {1, 1}, {3, 1}, {5, 1}}));
+    assert(window.top_k(0).empty());
+  }
+
+  void test_time_window() {
+    auto window = frequencies_type{0, 10};
+    window.push(7, 0);
+    window.push(7, 5);
+    window.push(8, 9);
+    assert(window.frequency(7) == 2);
+    window.push(8, 12);
+    assert(window.frequency(7) == 1);
+    assert((pairs(window.top_k(1)) == std::vector<std::pair<int32_t, size_t>>{{8, 2}}));
+    window.expire(30);
+    assert(window.empty());
+    assert(window.distinct_count() == 0);
+    assert(window.get_ranking_tree().empty());
+  }
+
+  void test_matches_model() {
+    const auto max_count = size_t{64};
+    auto window = frequencies_type{max_count};
+    auto model = std::deque<int32_t>{};
+    auto generator = std::mt19937{53};
+    auto keys = std::geometric_distribution<int32_t>{0.2};
+    for (auto step = 0; step < 5000; ++step) {
+      const auto key = keys(generator);
+      window.push(key);
+      model.push_back(key);
+      if (model.size() > max_count) {
+        model.pop_front();
+      }
+      auto frequencies = std::map<int32_t, size_t>{};
+      for (const auto item : model) {
+        ++frequencies[item];
+      }
+      auto expected = std::vector<std::pair<int32_t, size_t>>(
+        std::begin(frequencies), std::end(frequencies));
+      std::stable_sort(std::begin(expected), std::end(expected),
+        [](const std::pair<int32_t, size_t>& lhs, const std::pair<int32_t, size_t>& rhs) {
+          return lhs.second > rhs.second;
+        });
+      expected.resize(std::min(expected.size(), size_t{5}));
+      assert(window.distinct_count() == frequencies.size());
+      assert(window.frequency(key) == frequencies[key]);
+      assert(pairs(window.top_k(5)) == expected);
+      check_tree(window.get_counts_tree());
+      check_tree(window.get_ranking_tree());
+    }
+  }
+
+  void test_ranking_nodes_are_relinked() {
+    auto window = frequencies_type{4};
+    window.push(7);
+    const auto ranked = window.get_ranking_tree().root();
+    for (const auto key : {7, 8, 7, 7, 8, 8}) {
+      window.push(key);
+      check_tree(window.get_ranking_tree());
+    }
+    // window is 7 7 8 8, the node of key 7 moved between counts in place
+    assert((pairs(window.top_k(2)) == std::vector<std::pair<int32_t, size_t>>{{7, 2}, {8, 2}}));
+    assert(window.get_ranking_tree().root()->leftmost_node() == ranked);
+  }
+
+  void test_all() {
+    test_count_window();
+    test_time_window();
+    test_matches_model();
+    test_ranking_nodes_are_relinked();
+  }
+};
+
+class tree_partition_tester {
+ public:
+  struct identity_key_extractor {
+    int32_t operator () (int32_t value) const noexcept {
+      return value;
+    }
+  };
+
+  using tree_type = splay_tree<int32_t, int32_t, std::less<int32_t>, identity_key_extractor>;
+  using implicit_tree_type = implicit_splay_tree<int32_t>;
+
+  template <typename Tree>
+  static std::vector<int32_t> values(const Tree& tree) {
+    auto result = std::vector<int32_t>{};
+    if (tree.root() != nullptr) {
+      for (auto node = tree.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+        result.push_back(node->value);
+      }
+    }
+    return result;
+  }
+
+  void test_split_at_keys() {
+    auto tree = tree_type{{5, 1, 9, 3, 7, 11, 2}};
+    auto shards = tree.split_at_keys({3, 3, 8, 20});
+    assert(tree.empty());
+    assert(shards.size() == 5);
+    assert((values(shards[0]) == std::vector<int32_t>{1, 2}));
+    assert(shards[1].empty());
+    assert((values(shards[2]) == std::vector<int32_t>{3, 5, 7}));
+    assert((values(shards[3]) == std::vector<int32_t>{9, 11}));
+    assert(shards[4].empty());
+    for (const auto& shard : shards) {
+      check_tree(shard);
+    }
+    tree.concat(shards);
+    check_tree(tree);
+    assert((values(tree) == std::vector<int32_t>{1, 2, 3, 5, 7, 9, 11}));
+    for (const auto& shard : shards) {
+      assert(shard.empty());
+    }
+    auto whole = tree.split_at_keys({});
+    assert(whole.size() == 1 && whole.front().size() == 7);
+  }
+
+  void test_split_at_positions() {
+    auto tree = implicit_tree_type{{10, 11, 12, 13, 14, 15}};
+    auto pieces = tree.split_at_positions({0, 2, 5, 9});
+    assert(tree.empty());
+    assert(pieces.size() == 5);
+    assert(pieces[0].empty());
+    assert((values(pieces[1]) == std::vector<int32_t>{10, 11}));
+    assert((values(pieces[2]) == std::vector<int32_t>{12, 13, 14}));
+    assert((values(pieces[3]) == std::vector<int32_t>{15}));
+    assert(pieces[4].empty());
+    // reorder the pieces and join them back
+    std::swap(pieces[1], pieces[3]);
+    tree.concat(pieces);
+    check_tree(tree);
+    assert((values(tree) == std::vector<int32_t>{15, 12, 13, 14, 10, 11}));
+  }
+
+  void test_random_repartition() {
+    auto generator = std::mt19937{67};
+    auto keys = std::uniform_int_distribution<int32_t>{0, 1000};
+    auto tree = tree_type{};
+    auto model = std::set<int32_t>{};
+    for (auto idx = 0; idx < 500; ++idx) {
+      const auto key = keys(generator);
+      tree.insert(key);
+      model.insert(key);
+    }
+    for (auto round = 0; round < 20; ++round) {
+      auto pivots = std::vector<int32_t>{};
+      for (auto idx = 0; idx < round; ++idx) {
+        pivots.push_back(keys(generator));
+      }
+      std::sort(std::begin(pivots), std::end(pivots));
+      auto shards = tree.split_at_keys(pivots);
+      assert(shards.size() == pivots.size() + 1);
+      for (auto idx = size_t{0}; idx < shards.size(); ++idx) {
+        check_tree(shards[idx]);
+        const auto low = idx > 0 ? model.lower_bound(pivots[idx - 1]) : std::begin(model);
+        const auto high = idx < pivots.size() ? model.lower_bound(pivots[idx]) : std::end(model);
+        assert(values(shards[idx]) == std::vector<int32_t>(low, high));
+      }
+      tree.concat(shards);
+      check_tree(tree);
+      assert(values(tree) == std::vector<int32_t>(std::begin(model), std::end(model)));
+    }
+  }
+
+  void test_all() {
+    test_split_at_keys();
+    test_split_at_positions();
+    test_random_repartition();
+  }
+};
+
+class access_profile_tester {
+ public:
+  struct identity_key_extractor {
+    int32_t operator () (int32_t value) const noexcept {
+      return value;
+    }
+  };
+
+  using tree_type = splay_tree<int32_t, int32_t, std::less<int32_t>, identity_key_extractor>;
+  using profile_type = access_profile<int32_t>;
+
+  static size_t depth(const tree_node<int32_t>* node) {
+    auto result = size_t{0};
+    while (node->parent != nullptr) {
+      node = node->parent;
+      ++result;
+    }
+    return result;
+  }
+
+  void test_rebuild_puts_hot_keys_on_top() {
+    auto tree = tree_type{};
+    for (auto key = 0; key < 1000; ++key) {
+      tree.insert(key);
+    }
+    // sequential insertion leaves a path
+    assert(depth(tree.root()->leftmost_node()) == 999);
+    const auto hot_node = tree.find(700);
+    auto profile = profile_type{};
+    for (auto step = 0; step < 1000; ++step) {
+      profile.record(700);
+      profile.record(step % 10 * 100 + 50);
+    }
+    rebuild_from_profile(tree, profile);
+    check_tree(tree);
+    assert(tree.root() == hot_node);
+    assert(tree.size() == 1000);
+    auto key = 0;
+    auto max_depth = size_t{0};
+    for (auto node = tree.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+      assert(node->value == key++);
+      max_depth = std::max(max_depth, depth(node));
+    }
+    // total weight is 3000, a key with weight w is not deeper than log2(3000 / w) + 1
+    for (auto warm = 50; warm < 1000; warm += 100) {
+      assert(depth(tree.find(warm)) <= 5);
+      tree.rebuild_weighted(profile.weights(tree));
+    }
+    assert(max_depth <= 13);
+  }
+
+  void test_sampling_and_persistence() {
+    auto profile = profile_type{10};
+    for (auto step = 0; step < 100000; ++step) {
+      profile.record(step % 4);
+    }
+    assert(profile.size() == 4);
+    assert(8000 < profile.total_samples() && profile.total_samples() < 12000);
+    for (auto key = 0; key < 4; ++key) {
+      assert(1500 < profile.count(key) && profile.count(key) < 3500);
+    }
+    const auto saved = profile.entries();
+    auto restored = profile_type{};
+    restored.load(saved);
+    assert(restored.entries() == saved);
+    assert(restored.total_samples() == profile.total_samples());
+    restored.decay();
+    assert(restored.count(1) == profile.count(1) / 2);
+    auto tree = tree_type{{0, 1, 2, 3, 4}};
+    assert((restored.weights(tree) == std::vector<uint64_t>{
+      1 + restored.count(0), 1 + restored.count(1), 1 + restored.count(2), 1 + restored.count(3), 1}));
+  }
+
+  void test_all() {
+    test_rebuild_puts_hot_keys_on_top();
+    test_sampling_and_persistence();
+  }
+};
+
+class tree_distribution_tester {
+ public:
+  struct identity_key_extractor {
+    int32_t operator () (int32_t value) const noexcept {
+      return value;
+    }
+  };
+
+  using tree_type = splay_tree<int32_t, int32_t, std::less<int32_t>, identity_key_extractor>;
+
+  void test_quantile_summary() {
+    auto tree = tree_type{};
+    for (auto key = 0; key < 101; ++key) {
+      tree.insert(key * 10);
+    }
+    const auto root = tree.root();
+    assert((tree.quantile_summary(4) == std::vector<int32_t>{0, 250, 500, 750, 1000}));
+    assert((tree.quantile_summary(1) == std::vector<int32_t>{0, 1000}));
+    // queries don't splay
+    assert(tree.root() == root);
+    assert(tree_type{}.quantile_summary(3).empty());
+    assert((tree_type{{7}}.quantile_summary(2) == std::vector<int32_t>{7, 7, 7}));
+  }
+
+  void test_histogram() {
+    const auto tree = tree_type{{1, 3, 5, 7, 9, 11}};
+    const auto root = tree.root();
+    assert(tree.rank(0) == 0);
+    assert(tree.rank(5) == 2);
+    assert(tree.rank(6) == 3);
+    assert(tree.rank(100) == 6);
+    assert((tree.histogram({4, 8}) == std::vector<size_t>{2, 2, 2}));
+    assert((tree.histogram({0, 5, 5, 12}) == std::vector<size_t>{0, 2, 0, 4, 0}));
+    assert((tree.histogram({}) == std::vector<size_t>{6}));
+    assert(tree.root() == root);
+  }
+
+  void test_matches_sorted_keys() {
+    auto generator = std::mt19937{71};
+    auto keys = std::uniform_int_distribution<int32_t>{0, 100000};
+    auto tree = tree_type{};
+    auto model = std::set<int32_t>{};
+    for (auto idx = 0; idx < 5000; ++idx) {
+      const auto key = keys(generator);
+      tree.insert(key);
+      model.insert(key);
+    }
+    const auto sorted = std::vector<int32_t>(std::begin(model), std::end(model));
+    const auto b = size_t{16};
+    const auto summary = tree.quantile_summary(b);
+    for (auto idx = size_t{0}; idx <= b; ++idx) {
+      assert(summary[idx] == sorted[idx * (sorted.size() - 1) / b]);
+    }
+    const auto counts = tree.histogram(summary);
+    assert(counts.size() == b + 2);
+    assert(counts.front() == 0);
+    assert(counts.back() == 1);
+    for (auto idx = size_t{1}; idx <= b; ++idx) {
+      const auto expected = static_cast<size_t>(
+        std::lower_bound(std::begin(sorted), std::end(sorted), summary[idx]) -
+        std::lower_bound(std::begin(sorted), std::end(sorted), summary[idx - 1]));
+      assert(counts[idx] == expected);
+    }
+  }
+
+  void test_all() {
+    test_quantile_summary();
+    test_histogram();
+    test_matches_sorted_keys();
+  }
+};
+
+class tree_sampling_tester {
+ public:
+  struct identity_key_extractor {
+    int32_t operator () (int32_t value) const noexcept {
+      return value;
+    }
+  };
+
+  using tree_type = splay_tree<int32_t, int32_t, std::less<int32_t>, identity_key_extractor>;
+  using implicit_tree_type = implicit_splay_tree<int32_t>;
+
+  template <typename Node>
+  static std::vector<int32_t> values(const std::vector<Node>& nodes) {
+    auto result = std::vector<int32_t>{};
+    for (const auto& node : nodes) {
+      result.push_back(node->value);
+    }
+    return result;
+  }
+
+  void test_at_ranks() {
+    auto tree = tree_type{};
+    for (auto key = 0; key < 100; ++key) {
+      tree.insert(key * 2);
+    }
+    const auto root = tree.root();
+    assert((values(tree.at_ranks({50, 0, 99, 50, 3})) == std::vector<int32_t>{0, 6, 100, 100, 198}));
+    assert(tree.at_ranks({}).empty());
+    assert(tree.root() == root);
+    auto implicit_tree = implicit_tree_type{{5, 4, 3, 2, 1}};
+    assert((values(implicit_tree.at_ranks({4, 1, 1})) == std::vector<int32_t>{4, 4, 1}));
+  }
+
+  void test_at_ranks_out_of_range() {
+    auto tree = tree_type{};
+    for (auto key = 0; key < 10; ++key) {
+      tree.insert(key);
+    }
+    const auto nodes = tree.at_ranks({10, 3, 1000, 9});
+    assert(nodes.size() == 4);
+    assert(nodes[0]->value == 3 && nodes[1]->value == 9);
+    assert(nodes[2] == nullptr && nodes[3] == nullptr);
+    assert(tree.order_statistic(10) == nullptr);
+    assert(tree_type{}.at_ranks({0}).front() == nullptr);
+    auto implicit_tree = implicit_tree_type{{5, 4, 3}};
+    const auto positions = implicit_tree.at_ranks({3, 0});
+    assert(positions[0]->value == 5 && positions[1] == nullptr);
+  }
+
+  void test_sample_is_uniform() {
+    auto tree = tree_type{};
+    for (auto key = 0; key < 10; ++key) {
+      tree.insert(key);
+    }
+    const auto root = tree.root();
+    auto generator = std::mt19937{73};
+    const auto nodes = tree.sample(100000, generator);
+    assert(nodes.size() == 100000);
+    assert(tree.root() == root);
+    auto counts = std::vector<size_t>(10, 0);
+    for (auto idx = size_t{0}; idx < nodes.size(); ++idx) {
+      assert(idx == 0 || nodes[idx - 1]->value <= nodes[idx]->value);
+      ++counts[nodes[idx]->value];
+    }
+    for (const auto& count : counts) {
+      assert(9000 < count && count < 11000);
+    }
+    assert(tree_type{}.sample(5, generator).empty());
+  }
+
+  void test_sample_range() {
+    auto tree = tree_type{};
+    for (auto key = 0; key < 1000; ++key) {
+      tree.insert(key);
+    }
+    auto generator = std::mt19937{79};
+    const auto nodes = tree.sample_range(100, 199, 1000, generator);
+    assert(nodes.size() == 1000);
+    auto seen = std::set<int32_t>{};
+    for (const auto& node : nodes) {
+      assert(100 <= node->value && node->value <= 199);
+      seen.insert(node->value);
+    }
+    assert(seen.size() > 90);
+    assert(tree.sample_range(2000, 3000, 10, generator).empty());
+    auto implicit_tree = implicit_tree_type{};
+    for (auto value = 0; value < 100; ++value) {
+      implicit_tree.insert(value);
+    }
+    for (const auto& node : implicit_tree.sample_range(10, 20, 200, generator)) {
+      assert(10 <= node->value && node->value < 20);
+    }
+    assert(implicit_tree.sample_range(90, 200, 50, generator).size() == 50);
+    assert(implicit_tree.sample_range(200, 300, 50, generator).empty());
+  }
+
+  void test_all() {
+    test_at_ranks();
+    test_at_ranks_out_of_range();
+    test_sample_is_uniform();
+    test_sample_range();
+  }
+};
+
+class parallel_traversal_tester {
+ public:
+  struct identity_key_extractor {
+    int64_t operator () (int64_t value) const noexcept {
+      return value;
+    }
+  };
+
+  using tree_type = splay_tree<int64_t, int64_t, std::less<int64_t>, identity_key_extractor>;
+
+  static tree_type make_tree(int64_t count) {
+    auto keys = std::vector<int64_t>(count);
+    std::iota(std::begin(keys), std::end(keys), int64_t{0});
+    std::shuffle(std::begin(keys), std::end(keys), std::mt19937{83});
+    return tree_type{std::begin(keys), std::end(keys)};
+  }
+
+  void test_parallel_reduce() {
+    const auto tree = make_tree(10000);
+    const auto root = tree.root();
+    const auto plus = [](int64_t lhs, int64_t rhs) { return lhs + rhs; };
+    for (auto threads = size_t{1}; threads <= 8; ++threads) {
+      assert(parallel_reduce(tree, int64_t{0}, int64_t{9999}, int64_t{0}, plus, plus, threads) == 49995000);
+      assert(parallel_reduce(tree, int64_t{100}, int64_t{199}, int64_t{0}, plus, plus, threads) == 14950);
+      assert(parallel_reduce(tree, int64_t{-50}, int64_t{2}, int64_t{0}, plus, plus, threads) == 3);
+      assert(parallel_reduce(tree, int64_t{20000}, int64_t{30000}, int64_t{7}, plus, plus, threads) == 7);
+    }
+    // partial results are combined in key order
+    const auto concat = [](std::vector<int64_t> lhs, const std::vector<int64_t>& rhs) {
+      lhs.insert(std::end(lhs), std::begin(rhs), std::end(rhs));
+      return lhs;
+    };
+    const auto append = [](std::vector<int64_t> values, int64_t value) {
+      values.push_back(value);
+      return values;
+    };
+    const auto collected = parallel_reduce(
+      tree, int64_t{10}, int64_t{5009}, std::vector<int64_t>{}, append, concat, 4);
+    auto expected = std::vector<int64_t>(5000);
+    std::iota(std::begin(expected), std::end(expected), int64_t{10});
+    assert(collected == expected);
+    // bool partial results
+    const auto all_of = [](bool lhs, bool rhs) { return lhs && rhs; };
+    const auto below = [](int64_t bound) {
+      return [bound](bool accumulator, int64_t value) { return accumulator && value < bound; };
+    };
+    for (auto threads = size_t{1}; threads <= 8; ++threads) {
+      assert(parallel_reduce(tree, int64_t{0}, int64_t{999}, true, below(1000), all_of, threads));
+      assert(!parallel_reduce(tree, int64_t{0}, int64_t{999}, true, below(999), all_of, threads));
+    }
+    assert(tree.root() == root);
+  }
+
+  void test_parallel_for_each() {
+    const auto tree = make_tree(5000);
+    auto visited = std::vector<std::atomic<uint32_t>>(5000);
+    for (auto& count : visited) {
+      count = 0;
+    }
+    parallel_for_each(tree, int64_t{1000}, int64_t{3999}, [&visited](int64_t value) {
+      ++visited[static_cast<size_t>(value)];
+    }, 3);
+    for (auto idx = size_t{0}; idx < visited.size(); ++idx) {
+      assert(visited[idx] == (1000 <= idx && idx < 4000 ? 1u : 0u));
+    }
+    std::mutex mutex;
+    auto thrown = false;
+    try {
+      parallel_for_each(tree, int64_t{0}, int64_t{4999}, [&mutex](int64_t value) {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (value == 4321) {
+          throw std::runtime_error{"stop"};
+        }
+      }, 4);
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+
+  void test_all() {
+    test_parallel_reduce();
+    test_parallel_for_each();
+  }
+};
+
+class roaring_set_tester {
+ public:
+  using container_kind = detail::roaring_container::container_kind;
+
+  static container_kind kind_of(const roaring_set& set, size_t chunk) {
+    const tree_node<roaring_chunk>* node = set.get_tree().root()->leftmost_node();
+    for (auto idx = size_t{0}; idx < chunk; ++idx) {
+      node = node->next_node();
+    }
+    return node->value.values.get_kind();
+  }
+
+  void test_containers() {
+    auto set = roaring_set{};
+    for (auto value = int64_t{0}; value < 100; ++value) {
+      assert(set.insert(value * 7));
+    }
+    assert(!set.insert(14));
+    assert(set.chunk_count() == 1);
+    assert(kind_of(set, 0) == container_kind::kArray);
+    for (auto value = int64_t{0}; value < 10000; ++value) {
+      set.insert(value);
+    }
+    assert(kind_of(set, 0) == container_kind::kBitmap);
+    assert(set.size() == 10000);
+    assert(set.count(0, 9999) == 10000);
+    assert(set.count(100, 199) == 100);
+    set.run_optimize();
+    assert(kind_of(set, 0) == container_kind::kRun);
+    assert(set.contains(5000));
+    assert(!set.contains(10000));
+    assert(set.count(100, 199) == 100);
+    assert(set.rank(20000) == 10000);
+    assert(set.erase(5000));
+    assert(!set.contains(5000));
+    assert(kind_of(set, 0) == container_kind::kBitmap);
+    for (auto value = int64_t{0}; value < 9000; ++value) {
+      set.erase(value);
+    }
+    assert(kind_of(set, 0) == container_kind::kArray);
+    assert(set.size() == 1000);
+  }
+
+  void test_negative_and_sparse_values() {
+    auto set = roaring_set{};
+    const auto values = std::vector<int64_t>{
+      std::numeric_limits<int64_t>::min(), -70000, -1, 0, 1, 65535, 65536, std::numeric_limits<int64_t>::max()};
+    for (const auto& value : values) {
+      set.insert(value);
+    }
+    auto visited = std::vector<int64_t>{};
+    set.for_each([&visited](int64_t value) {
+      visited.push_back(value);
+    });
+    assert(visited == values);
+    assert(set.count(-1, 1) == 3);
+    assert(set.count(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()) == values.size());
+    assert(set.rank(0) == 3);
+    assert(set.erase(-70000));
+    assert(!set.erase(-70000));
+    assert(set.chunk_count() == 5);
+  }
+
+  void test_matches_model() {
+    auto set = roaring_set{};
+    auto model = std::set<int64_t>{};
+    auto generator = std::mt19937{89};
+    // a few dense clusters and a sparse background
+    auto cluster = std::uniform_int_distribution<int64_t>{0, 3};
+    auto offset = std::uniform_int_distribution<int64_t>{0, 20000};
+    auto sparse = std::uniform_int_distribution<int64_t>{-10000000, 10000000};
+    for (auto step = 0; step < 60000; ++step) {
+      const auto value = step % 5 == 0 ? sparse(generator) : cluster(generator) * 1000000 + offset(generator);
+      if (step % 3 == 0) {
+        assert(set.erase(value) == (model.erase(value) == 1));
+      } else {
+        assert(set.insert(value) == model.insert(value).second);
+      }
+      if (step % 5000 == 0) {
+        set.run_optimize();
+      }
+      if (step % 500 == 0) {
+        const auto low = sparse(generator);
+        const auto high = low + offset(generator) * 100;
+        const auto expected = static_cast<size_t>(
+          std::distance(model.lower_bound(low), model.upper_bound(high)));
+        assert(set.count(low, high) == expected);
+        assert(set.size() == model.size());
+        check_tree(set.get_tree());
+      }
+    }
+    auto visited = std::vector<int64_t>{};
+    set.for_each([&visited](int64_t value) {
+      visited.push_back(value);
+    });
+    assert(visited == std::vector<int64_t>(std::begin(model), std::end(model)));
+  }
+
+  void test_memory_of_dense_set() {
+    auto set = roaring_set{};
+    for (auto value = int64_t{0}; value < 1000000; ++value) {
+      set.insert(value);
+    }
+    // a node per value would take at least 40 bytes per value
+    assert(set.memory_usage() < 1000000 * 40 / 10);
+    set.run_optimize();
+    assert(set.memory_usage() < 10000);
+    assert(set.count(12345, 654320) == 641976);
+  }
+
+  void test_copy_and_assignment() {
+    auto set = roaring_set{};
+    auto generator = std::mt19937{127};
+    auto values = std::uniform_int_distribution<int64_t>{-300000, 300000};
+    for (auto idx = 0; idx < 100000; ++idx) {
+      set.insert(values(generator));
+    }
+    for (auto value = int64_t{1000000}; value < 1100000; ++value) {
+      set.insert(value);
+    }
+    set.run_optimize();
+    const auto expected_size = set.size();
+    const auto expected_count = set.count(-1000, 1050000);
+    auto copy = set;
+    assert(copy.size() == expected_size);
+    assert(copy.chunk_count() == set.chunk_count());
+    assert(copy.count(-1000, 1050000) == expected_count);
+    assert(copy.rank(0) == set.rank(0));
+    auto assigned = roaring_set{};
+    assigned.insert(5);
+    assigned = copy;
+    assert(assigned.size() == expected_size);
+    assert(assigned.count(-1000, 1050000) == expected_count);
+    // copies are independent
+    copy.insert(2000000);
+    assert(copy.size() == expected_size + 1);
+    assert(set.size() == expected_size);
+    assert(assigned.size() == expected_size);
+  }
+
+  void test_all() {
+    test_containers();
+    test_negative_and_sparse_values();
+    test_matches_model();
+    test_memory_of_dense_set();
+    test_copy_and_assignment();
+  }
+};
+
+class implicit_sequence_tester {
+ public:
+  using tree_type = implicit_splay_tree<int32_t>;
+
+  static std::vector<int32_t> values(const tree_type& tree) {
+    return std::vector<int32_t>(tree.begin(), tree.end());
+  }
+
+  void test_deque_operations() {
+    auto tree = tree_type{};
+    tree.push_back(2);
+    tree.push_front(1);
+    tree.push_back(3);
+    tree.push_front(0);
+    check_tree(tree);
+    assert((values(tree) == std::vector<int32_t>{0, 1, 2, 3}));
+    assert(tree.front() == 0);
+    assert(tree.back() == 3);
+    tree.insert_at(2, 10);
+    tree.insert_at(0, -1);
+    tree.insert_at(tree.size(), 20);
+    check_tree(tree);
+    assert((values(tree) == std::vector<int32_t>{-1, 0, 1, 10, 2, 3, 20}));
+    assert(tree[3] == 10);
+    tree[3] = 11;
+    assert(tree[3] == 11);
+    tree.pop_front();
+    tree.pop_back();
+    check_tree(tree);
+    assert((values(tree) == std::vector<int32_t>{0, 1, 11, 2, 3}));
+    while (!tree.empty()) {
+      tree.pop_back();
+    }
+    assert(tree.root() == nullptr);
+  }
+
+  void test_iterator() {
+    auto tree = tree_type{};
+    for (auto value = 0; value < 1000; ++value) {
+      tree.push_back(value);
+    }
+    auto it = tree.begin();
+    assert(*it == 0);
+    assert(*(it + 5) == 5);
+    assert(*(it + 500) == 500);
+    assert(it[999] == 999);
+    assert(tree.end() - tree.begin() == 1000);
+    assert(*(tree.end() - 1) == 999);
+    assert(*(tree.end() - 100) == 900);
+    auto last = tree.end();
+    --last;
+    assert(*last == 999);
+    assert(it < last && last > it && it <= it && last >= it);
+    for (auto& value : tree) {
+      value *= 2;
+    }
+    const auto root = tree.root();
+    const auto& const_tree = tree;
+    auto expected = 0;
+    for (auto cit = const_tree.begin(); cit != const_tree.end(); ++cit) {
+      assert(*cit == expected);
+      expected += 2;
+    }
+    // const iterators don't splay
+    assert(*std::lower_bound(const_tree.begin(), const_tree.end(), 1001) == 1002);
+    assert(tree.root() == root);
+    tree_type::const_iterator converted = tree.begin() + 7;
+    assert(*converted == 14);
+    // binary search on the sorted sequence through random access iterators
+    assert(*std::lower_bound(tree.begin(), tree.end(), 1001) == 1002);
+    assert(std::distance(tree.begin(), std::upper_bound(tree.begin(), tree.end(), 100)) == 51);
+    // long jumps of mutable iterators splay their target
+    auto jump = tree.begin() + 600;
+    assert(&tree.root()->value == &*jump && *jump == 1200);
+  }
+
+  void test_iterator_jumps_on_path() {
+    // push_back builds a left path, long jumps must not walk it every time
+    auto tree = tree_type{};
+    const auto count = 200000;
+    for (auto value = 0; value < count; ++value) {
+      tree.push_back(value * 3);
+    }
+    auto generator = std::mt19937{131};
+    auto targets = std::uniform_int_distribution<int32_t>{0, 3 * count};
+    for (auto query = 0; query < 200; ++query) {
+      const auto target = targets(generator);
+      const auto it = std::lower_bound(tree.begin(), tree.end(), target);
+      const auto expected = (target + 2) / 3;
+      assert(it - tree.begin() == expected);
+      assert(expected == count || *it == expected * 3);
+    }
+    check_tree(tree);
+  }
+
+  void test_work_queue() {
+    auto tree = tree_type{};
+    auto model = std::deque<int32_t>{};
+    auto generator = std::mt19937{97};
+    auto action = std::uniform_int_distribution<int32_t>{0, 99};
+    for (auto step = 0; step < 20000; ++step) {
+      const auto roll = action(generator);
+      if (roll < 35) {
+        tree.push_back(step);
+        model.push_back(step);
+      } else if (roll < 55) {
+        tree.push_front(step);
+        model.push_front(step);
+      } else if (roll < 60) {
+        const auto position = static_cast<size_t>(generator() % (model.size() + 1));
+        tree.insert_at(position, step);
+        model.insert(std::begin(model) + position, step);
+      } else if (!model.empty() && roll < 80) {
+        assert(tree.front() == model.front());
+        tree.pop_front();
+        model.pop_front();
+      } else if (!model.empty()) {
+        assert(tree.back() == model.back());
+        tree.pop_back();
+        model.pop_back();
+      }
+      assert(tree.size() == model.size());
+      if (step % 1000 == 0) {
+        check_tree(tree);
+        assert(values(tree) == std::vector<int32_t>(std::begin(model), std::end(model)));
+        if (!model.empty()) {
+          const auto position = static_cast<size_t>(generator() % model.size());
+          assert(tree[position] == model[position]);
+        }
+      }
+    }
+  }
+
+  void test_all() {
+    test_deque_operations();
+    test_iterator();
+    test_iterator_jumps_on_path();
+    test_work_queue();
+  }
+};
+
+class lsm_index_tester {
+ public:
+  using index_type = lsm_index<int32_t, int32_t>;
+
+  static std::vector<std::pair<int32_t, int32_t>> items(index_type& index) {
+    auto result = std::vector<std::pair<int32_t, int32_t>>{};
+    index.for_each([&result](int32_t key, int32_t value) {
+      result.emplace_back(key, value);
+    });
+    return result;
+  }
+
+  void test_levels_and_tombstones() {
+    index_type index{4};
+    for (auto key = 0; key < 8; ++key) {
+      index.put(key, key * 10);
+    }
+    index.flush();
+    assert(index.memtable_size() == 0);
+    assert(index.run_count() >= 1);
+    index.put(3, 33);
+    index.erase(5);
+    auto value = int32_t{0};
+    assert(index.find(3, value) && value == 33);
+    assert(!index.find(5, value));
+    assert(index.find(6, value) && value == 60);
+    assert(!index.contains(100));
+    assert(index.count_range(2, 6) == 4);
+    index.flush();
+    assert(index.find(3, value) && value == 33);
+    assert(!index.find(5, value));
+    assert((items(index) == std::vector<std::pair<int32_t, int32_t>>{
+      {0, 0}, {1, 10}, {2, 20}, {3, 33}, {4, 40}, {6, 60}, {7, 70}}));
+    auto range = std::vector<int32_t>{};
+    index.for_each_range(4, 100, [&range](int32_t key, int32_t) {
+      range.push_back(key);
+    });
+    assert((range == std::vector<int32_t>{4, 6, 7}));
+  }
+
+  void test_matches_model() {
+    index_type index{64};
+    auto model = std::map<int32_t, int32_t>{};
+    auto generator = std::mt19937{101};
+    auto keys = std::uniform_int_distribution<int32_t>{0, 2000};
+    for (auto step = 0; step < 30000; ++step) {
+      const auto key = keys(generator);
+      if (step % 4 == 0) {
+        index.erase(key);
+        model.erase(key);
+      } else {
+        index.put(key, step);
+        model[key] = step;
+      }
+      if (step % 1000 == 0) {
+        const auto probe = keys(generator);
+        auto value = int32_t{0};
+        const auto it = model.find(probe);
+        assert(index.find(probe, value) == (it != model.end()));
+        assert(it == model.end() || value == it->second);
+        const auto low = keys(generator);
+        const auto high = low + 300;
+        const auto expected = static_cast<size_t>(
+          std::distance(model.lower_bound(low), model.upper_bound(high)));
+        assert(index.count_range(low, high) == expected);
+      }
+    }
+    const auto expected_items = std::vector<std::pair<int32_t, int32_t>>(std::begin(model), std::end(model));
+    assert(items(index) == expected_items);
+    index.flush();
+    assert(items(index) == expected_items);
+    // runs have geometrically growing sizes
+    assert(index.run_count() <= 12);
+  }
+
+  void test_concurrent_writers_and_readers() {
+    index_type index{128};
+    auto writers = std::vector<std::thread>{};
+    for (auto thread = 0; thread < 4; ++thread) {
+      writers.emplace_back([&index, thread]() {
+        for (auto key = thread; key < 20000; key += 4) {
+          index.put(key, key + 1);
+          if (key % 100 == 0) {
+            auto value = int32_t{0};
+            assert(index.find(key, value) && value == key + 1);
+          }
+        }
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    assert(index.count_range(0, 19999) == 20000);
+    index.flush();
+    assert(index.count_range(5000, 5999) == 1000);
+  }
+
+  void test_all() {
+    test_levels_and_tombstones();
+    test_matches_model();
+    test_concurrent_writers_and_readers();
+  }
+};
+
+class buffered_tree_tester {
+ public:
+  struct pair_key_extractor {
+    int32_t operator () (const std::pair<int32_t, int32_t>& value) const noexcept {
+      return value.first;
+    }
+  };
+
+  using tree_type = buffered_tree<int32_t, std::pair<int32_t, int32_t>, std::less<int32_t>, pair_key_extractor>;
+
+  void test_batches_and_read_your_writes() {
+    tree_type tree{4};
+    auto value = std::pair<int32_t, int32_t>{};
+    {
+      auto buffer = tree.make_buffer();
+      buffer.insert({5, 1});
+      buffer.insert({3, 1});
+      buffer.insert({5, 2});
+      assert(buffer.size() == 3);
+      assert(!tree.contains(5));
+      assert(tree.find(5, value, buffer) && value.second == 2);
+      assert(buffer.empty());
+      assert(tree.batch_count() == 1);
+      buffer.erase(3);
+      buffer.insert({3, 7});
+      buffer.erase(5);
+      buffer.insert({9, 1});
+      // the fourth write fills the buffer
+      assert(buffer.empty());
+      assert(tree.batch_count() == 2);
+      assert(tree.find(3, value) && value.second == 7);
+      assert(!tree.contains(5));
+      buffer.insert({1, 1});
+    }
+    // the buffer is flushed on destruction
+    assert(tree.contains(1));
+    assert(tree.size() == 3);
+    const auto keys = tree.with_tree([](tree_type::tree_type& shared) {
+      auto result = std::vector<int32_t>{};
+      for (auto node = shared.root()->leftmost_node(); node != nullptr; node = node->next_node()) {
+        result.push_back(node->value.first);
+      }
+      return result;
+    });
+    assert((keys == std::vector<int32_t>{1, 3, 9}));
+  }
+
+  void test_matches_model() {
+    tree_type tree{64};
+    auto buffer = tree.make_buffer();
+    auto model = std::map<int32_t, int32_t>{};
+    auto generator = std::mt19937{113};
+    auto keys = std::uniform_int_distribution<int32_t>{0, 500};
+    for (auto step = 0; step < 20000; ++step) {
+      const auto key = keys(generator);
+      if (step % 3 == 0) {
+        buffer.erase(key);
+        model.erase(key);
+      } else {
+        buffer.insert({key, step});
+        model[key] = step;
+      }
+      if (step % 997 == 0) {
+        auto value = std::pair<int32_t, int32_t>{};
+        const auto it = model.find(key);
+        assert(tree.find(key, value, buffer) == (it != model.end()));
+        assert(it == model.end() || value.second == it->second);
+      }
+    }
+    buffer.flush();
+    assert(tree.size() == model.size());
+    tree.with_tree([&model](tree_type::tree_type& shared) {
+      check_tree(shared);
+      auto it = model.begin();
+      for (auto node = shared.root()->leftmost_node(); node != nullptr; node = node->next_node(), ++it) {
+        assert(node->value.first == it->first && node->value.second == it->second);
+      }
+      return 0;
+    });
+  }
+
+  void test_concurrent_writers() {
+    tree_type tree{32};
+    auto writers = std::vector<std::thread>{};
+    for (auto thread = 0; thread < 8; ++thread) {
+      writers.emplace_back([&tree, thread]() {
+        auto buffer = tree.make_buffer();
+        for (auto key = thread; key < 16000; key += 8) {
+          buffer.insert({key, thread});
+          if (key % 3 == 0) {
+            buffer.erase(key);
+          }
+        }
+        auto value = std::pair<int32_t, int32_t>{};
+        assert(tree.find(thread + 8, value, buffer) == ((thread + 8) % 3 != 0));
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    assert(tree.size() == 16000 - 16000 / 3 - 1);
+    assert(tree.batch_count() < 16000 / 8);
+  }
+
+  void test_all() {
+    test_batches_and_read_your_writes();
+    test_matches_model();
+    test_concurrent_writers();
+  }
+};
+
 }  // namespace test
 }  // namespace splay
 
@@ -1364,6 +3909,54 @@ int main() {
   splay_tester.test_all();
   auto implicit_splay_tester = splay::test::splay_tree_tester{};
   implicit_splay_tester.test_all();
+  auto sequence_hash_tester = splay::test::sequence_hash_tester{};
+  sequence_hash_tester.test_all();
+  auto subtree_digest_tester = splay::test::subtree_digest_tester{};
+  subtree_digest_tester.test_all();
+  auto splay_lru_cache_tester = splay::test::splay_lru_cache_tester{};
+  splay_lru_cache_tester.test_all();
+  auto interval_map_tester = splay::test::interval_map_tester{};
+  interval_map_tester.test_all();
+  auto interval_tree_tester = splay::test::interval_tree_tester{};
+  interval_tree_tester.test_all();
+  auto sliding_window_quantiles_tester = splay::test::sliding_window_quantiles_tester{};
+  sliding_window_quantiles_tester.test_all();
+  auto expiring_range_counter_tester = splay::test::expiring_range_counter_tester{};
+  expiring_range_counter_tester.test_all();
+  auto order_book_tester = splay::test::order_book_tester{};
+  order_book_tester.test_all();
+  auto reuse_distance_analyzer_tester = splay::test::reuse_distance_analyzer_tester{};
+  reuse_distance_analyzer_tester.test_all();
+  auto ranking_index_tester = splay::test::ranking_index_tester{};
+  ranking_index_tester.test_all();
+  auto splay_priority_queue_tester = splay::test::splay_priority_queue_tester{};
+  splay_priority_queue_tester.test_all();
+  auto splay_timer_queue_tester = splay::test::splay_timer_queue_tester{};
+  splay_timer_queue_tester.test_all();
+  auto free_space_index_tester = splay::test::free_space_index_tester{};
+  free_space_index_tester.test_all();
+  auto rectangle_counter_tester = splay::test::rectangle_counter_tester{};
+  rectangle_counter_tester.test_all();
+  auto sliding_window_frequencies_tester = splay::test::sliding_window_frequencies_tester{};
+  sliding_window_frequencies_tester.test_all();
+  auto tree_partition_tester = splay::test::tree_partition_tester{};
+  tree_partition_tester.test_all();
+  auto access_profile_tester = splay::test::access_profile_tester{};
+  access_profile_tester.test_all();
+  auto tree_distribution_tester = splay::test::tree_distribution_tester{};
+  tree_distribution_tester.test_all();
+  auto tree_sampling_tester = splay::test::tree_sampling_tester{};
+  tree_sampling_tester.test_all();
+  auto parallel_traversal_tester = splay::test::parallel_traversal_tester{};
+  parallel_traversal_tester.test_all();
+  auto roaring_set_tester = splay::test::roaring_set_tester{};
+  roaring_set_tester.test_all();
+  auto implicit_sequence_tester = splay::test::implicit_sequence_tester{};
+  implicit_sequence_tester.test_all();
+  auto lsm_index_tester = splay::test::lsm_index_tester{};
+  lsm_index_tester.test_all();
+  auto buffered_tree_tester = splay::test::buffered_tree_tester{};
+  buffered_tree_tester.test_all();
   std::cout << "All tests are passed!\n";
   return 0;
 }
\ No newline at end of file